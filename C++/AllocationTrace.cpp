@@ -0,0 +1,91 @@
+#include "AllocationTrace.h"
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+void TraceWriter::Open(const std::string& path)
+{
+	Close();
+	m_File.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_File)
+		throw std::runtime_error("could not open trace file");
+
+	TraceFileHeader header{ { 'A', 'T', 'R', 'C' }, TraceVersion, 0 };
+	m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	m_RecordAmount = 0;
+}
+
+void TraceWriter::Write(const TraceRecord* pRecords, size_t amount)
+{
+	m_File.write(reinterpret_cast<const char*>(pRecords), std::streamsize(amount * sizeof(TraceRecord)));
+	m_RecordAmount += amount;
+}
+
+void TraceWriter::Close()
+{
+	if (!m_File.is_open())
+		return;
+
+	m_File.seekp(offsetof(TraceFileHeader, recordAmount));
+	m_File.write(reinterpret_cast<const char*>(&m_RecordAmount), sizeof(m_RecordAmount));
+	m_File.close();
+}
+
+std::vector<TraceRecord> LoadTrace(const std::string& path)
+{
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+	if (!file)
+		throw std::runtime_error("could not open trace file");
+
+	const size_t fileBytes = size_t(file.tellg());
+	file.seekg(0);
+	TraceFileHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || memcmp(header.magic, "ATRC", 4) != 0 || header.version != TraceVersion)
+		throw std::runtime_error("not a trace file");
+
+	size_t amount = (fileBytes - sizeof(header)) / sizeof(TraceRecord);
+	if (header.recordAmount && header.recordAmount < amount)
+		amount = size_t(header.recordAmount);
+
+	std::vector<TraceRecord> records(amount);
+	file.read(reinterpret_cast<char*>(records.data()), std::streamsize(amount * sizeof(TraceRecord)));
+	return records;
+}
+
+void SaveTrace(const std::string& path, const std::vector<TraceRecord>& records)
+{
+	TraceWriter writer{};
+	writer.Open(path);
+	writer.Write(records.data(), records.size());
+	writer.Close();
+}
+
+size_t CompactTraceIds(std::vector<TraceRecord>& records)
+{
+	std::unordered_map<uint64_t, uint64_t> ids{};
+	uint64_t nextId = 0;
+	size_t writeIdx = 0;
+	for (const TraceRecord& record : records)
+	{
+		TraceRecord compacted = record;
+		if (record.operation == eTraceOperation::Acquire)
+		{
+			compacted.id = nextId;
+			ids[record.id] = nextId++;
+		}
+		else
+		{
+			// releases of blocks acquired before recording started are dropped
+			auto it = ids.find(record.id);
+			if (it == ids.end())
+				continue;
+			compacted.id = it->second;
+			ids.erase(it);
+		}
+		records[writeIdx++] = compacted;
+	}
+	records.resize(writeIdx);
+	return size_t(nextId);
+}
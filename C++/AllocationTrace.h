@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary allocation trace: a TraceFileHeader followed by 24 byte TraceRecords, little endian.
+// Written by TracingMemoryAllocator, replayed by Benchmarks/AllocatorBenchmark.
+enum class eTraceOperation : uint8_t
+{
+	Acquire,
+	Release,
+};
+
+struct TraceFileHeader
+{
+	char magic[4];			// "ATRC"
+	uint32_t version;
+	uint64_t recordAmount;	// 0 when the writer did not close cleanly, read until the end of the file then
+};
+
+struct TraceRecord
+{
+	uint64_t id;				// matches a Release with its Acquire
+	uint64_t size;				// requested bytes, 0 for Release
+	uint32_t timeDelta;			// nanoseconds since the previous record
+	uint16_t threadId;
+	eTraceOperation operation;
+	uint8_t reserved;
+};
+
+static_assert(sizeof(TraceFileHeader) == 16, "trace header layout changed");
+static_assert(sizeof(TraceRecord) == 24, "trace record layout changed");
+
+const uint32_t TraceVersion = 1;
+
+class TraceWriter
+{
+public:
+	TraceWriter() : m_RecordAmount{ 0 } {};
+	~TraceWriter() { Close(); };
+	void Open(const std::string& path);
+	void Write(const TraceRecord* pRecords, size_t amount);
+	// patches the record amount into the header
+	void Close();
+	bool IsOpen() const { return m_File.is_open(); };
+
+	TraceWriter(const TraceWriter& other) = delete;
+	TraceWriter(TraceWriter&& other) = delete;
+	TraceWriter& operator=(const TraceWriter& other) = delete;
+	TraceWriter& operator=(TraceWriter&& other) = delete;
+
+private:
+	std::ofstream m_File;
+	uint64_t m_RecordAmount;
+};
+
+std::vector<TraceRecord> LoadTrace(const std::string& path);
+void SaveTrace(const std::string& path, const std::vector<TraceRecord>& records);
+// renumbers ids to 0..n-1 in order of their Acquire, so a replay can index pointers directly
+size_t CompactTraceIds(std::vector<TraceRecord>& records);
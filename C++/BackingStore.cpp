@@ -0,0 +1,149 @@
+#include "BackingStore.h"
+#include <cstdint>
+#include <cstdlib>
+#if defined (_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const size_t HugePageBytes = size_t(2) << 20;
+
+	size_t GetPageBytes()
+	{
+#if defined (_WIN32)
+		static const size_t pageBytes = []()
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return size_t(info.dwPageSize);
+		}();
+#else
+		static const size_t pageBytes = size_t(sysconf(_SC_PAGESIZE));
+#endif
+		return pageBytes;
+	}
+
+	size_t RoundUp(size_t nbBytes, size_t alignment)
+	{
+		return (nbBytes + alignment - 1) / alignment * alignment;
+	}
+
+	// the same size has to be used for acquiring and releasing a mapping
+	size_t GetMappedBytes(size_t nbBytes, eBackingStore store)
+	{
+		if (store == eBackingStore::HugePages || nbBytes >= HugePageBytes)
+			return RoundUp(nbBytes, HugePageBytes);
+		return RoundUp(nbBytes, GetPageBytes());
+	}
+
+#if !defined (_WIN32)
+	void* MapAligned(size_t nbBytes, size_t alignment)
+	{
+		// over map and cut off both ends, so transparent huge pages can back the whole range
+		const size_t mappedBytes = nbBytes + alignment;
+		void* pMapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (pMapped == MAP_FAILED)
+			return nullptr;
+
+		const uintptr_t begin = reinterpret_cast<uintptr_t>(pMapped);
+		const uintptr_t alignedBegin = RoundUp(begin, alignment);
+		if (alignedBegin > begin)
+			munmap(pMapped, alignedBegin - begin);
+		const uintptr_t end = alignedBegin + nbBytes;
+		if (begin + mappedBytes > end)
+			munmap(reinterpret_cast<void*>(end), begin + mappedBytes - end);
+		return reinterpret_cast<void*>(alignedBegin);
+	}
+#endif
+}
+
+void* AcquireBackingStore(size_t nbBytes, eBackingStore store)
+{
+	if (store == eBackingStore::Heap)
+		return malloc(nbBytes);
+
+	const size_t mappedBytes = GetMappedBytes(nbBytes, store);
+#if defined (_WIN32)
+	if (store == eBackingStore::HugePages)
+	{
+		// needs SeLockMemoryPrivilege, without it this fails and regular pages are used
+		const size_t largePageBytes = GetLargePageMinimum();
+		if (largePageBytes && mappedBytes % largePageBytes == 0)
+		{
+			void* pStart = VirtualAlloc(nullptr, mappedBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (pStart)
+				return pStart;
+		}
+	}
+	return VirtualAlloc(nullptr, mappedBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+#if defined (MAP_HUGETLB)
+	if (store == eBackingStore::HugePages)
+	{
+		// only succeeds when huge pages are reserved in /proc/sys/vm/nr_hugepages
+		void* pStart = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (pStart != MAP_FAILED)
+			return pStart;
+	}
+#endif
+	if (mappedBytes < HugePageBytes)
+	{
+		void* pStart = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return pStart != MAP_FAILED ? pStart : nullptr;
+	}
+
+	void* pStart = MapAligned(mappedBytes, HugePageBytes);
+#if defined (MADV_HUGEPAGE)
+	if (pStart)
+		madvise(pStart, mappedBytes, MADV_HUGEPAGE);
+#endif
+	return pStart;
+#endif
+}
+
+void ReleaseBackingStore(void* pStart, size_t nbBytes, eBackingStore store)
+{
+	if (pStart == nullptr)
+		return;
+
+	if (store == eBackingStore::Heap)
+	{
+		free(pStart);
+		return;
+	}
+
+#if defined (_WIN32)
+	(void)nbBytes;
+	VirtualFree(pStart, 0, MEM_RELEASE);
+#else
+	munmap(pStart, GetMappedBytes(nbBytes, store));
+#endif
+}
+
+void DiscardPages(void* pStart, size_t nbBytes, eBackingStore store)
+{
+	if (store == eBackingStore::Heap)
+		return;
+
+	const size_t pageBytes = GetPageBytes();
+	const uintptr_t begin = RoundUp(reinterpret_cast<uintptr_t>(pStart), pageBytes);
+	const uintptr_t end = (reinterpret_cast<uintptr_t>(pStart) + nbBytes) / pageBytes * pageBytes;
+	if (end <= begin)
+		return;
+
+#if defined (_WIN32)
+	VirtualAlloc(reinterpret_cast<void*>(begin), end - begin, MEM_RESET, PAGE_READWRITE);
+#else
+#if defined (MADV_FREE)
+	// lazily reclaimed, falls back on kernels older than 4.5
+	if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_FREE) == 0)
+		return;
+#endif
+	madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#endif
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+enum class eBackingStore
+{
+	Heap,		// malloc, the default
+	Mapped,		// anonymous mapping from the OS, transparent huge pages where available
+	HugePages,	// explicit huge/large pages, falls back to Mapped when none can be had
+};
+
+void* AcquireBackingStore(size_t nbBytes, eBackingStore store);
+void ReleaseBackingStore(void* pStart, size_t nbBytes, eBackingStore store);
+
+// Hands the whole pages inside [pStart, pStart + nbBytes) back to the OS while keeping them
+// mapped, their content is undefined afterwards. Does nothing for heap memory.
+void DiscardPages(void* pStart, size_t nbBytes, eBackingStore store);
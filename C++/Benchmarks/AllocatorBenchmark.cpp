@@ -0,0 +1,435 @@
+// Runs synthetic workloads and recorded traces against every allocator and prints
+// throughput, p50/p99/p999 latency and peak external fragmentation, malloc is the baseline.
+// usage: AllocatorBenchmark [--ops n] [--live n] [--seed n] [--arena mb] [trace files...]
+#include "../AllocationTrace.h"
+#include "../DoubleLinkedListMemoryAllocator.h"
+#include "../LinkedListMemoryAllocator.h"
+#include "../TLSFMemoryAllocator.h"
+#include "../ThreadCachedMemoryAllocator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	class MallocMemoryAllocator : public MemoryAllocator
+	{
+	public:
+		virtual void* Acquire(size_t nbBytes = 0) override
+		{
+			void* pData = malloc(nbBytes ? nbBytes : 1);
+			if (!pData)
+				throw std::bad_alloc{};
+			return pData;
+		};
+		virtual void Release(void* pStart) override { free(pStart); };
+	};
+
+	// lets the single threaded allocators take part in the producer consumer workload
+	class LockedMemoryAllocator : public MemoryAllocator
+	{
+	public:
+		LockedMemoryAllocator(MemoryAllocator& allocator) : m_Allocator{ allocator } {};
+		virtual void* Acquire(size_t nbBytes = 0) override
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			return m_Allocator.Acquire(nbBytes);
+		};
+		virtual void Release(void* pStart) override
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_Allocator.Release(pStart);
+		};
+
+	private:
+		MemoryAllocator& m_Allocator;
+		std::mutex m_Mutex;
+	};
+
+	struct Settings
+	{
+		size_t operations = 400000;
+		size_t liveAmount = 2000;
+		uint32_t seed = 1;
+		size_t arenaBytes = size_t(64) << 20;
+		std::vector<std::string> tracePaths;
+	};
+
+	struct Candidate
+	{
+		const char* name;
+		std::function<std::unique_ptr<MemoryAllocator>(size_t)> create;
+		// ratio of free memory outside the largest free run, nullptr when it cannot be seen
+		std::function<double(const MemoryAllocator&)> fragmentation;
+		bool isThreadSafe;
+	};
+
+	struct Result
+	{
+		double seconds = 0.0;
+		size_t operations = 0;
+		size_t failures = 0;
+		std::vector<uint32_t> latencies;
+		double peakFragmentation = -1.0;
+	};
+
+	// free runs are every stretch that is not used, lazily merged neighbours count as one
+	double FragmentationOfUsage(const std::string& usage, char used)
+	{
+		size_t freeBlocks = 0;
+		size_t largestRun = 0;
+		size_t run = 0;
+		for (size_t i = 1; i <= usage.size(); i++)
+		{
+			if (i < usage.size() && usage[i] != used)
+			{
+				run++;
+				continue;
+			}
+			freeBlocks += run;
+			largestRun = std::max(largestRun, run);
+			run = 0;
+		}
+		return freeBlocks ? 1.0 - double(largestRun) / double(freeBlocks) : 0.0;
+	}
+
+	template<typename TAllocator>
+	double Fragmentation(const MemoryAllocator& allocator)
+	{
+		return FragmentationOfUsage(static_cast<const TAllocator&>(allocator).UsageToString('H', 'B', '-', 'x'), 'x');
+	}
+
+	// from the incrementally kept stats, free runs are only walked after the largest one left
+	template<typename TAllocator>
+	double StatsFragmentation(const MemoryAllocator& allocator)
+	{
+		return static_cast<const TAllocator&>(allocator).GetStats().GetExternalFragmentation();
+	}
+
+	std::vector<Candidate> CreateCandidates()
+	{
+		return {
+			{ "malloc", [](size_t) { return std::make_unique<MallocMemoryAllocator>(); }, nullptr, true },
+			{ "LLMA address", [](size_t nbBytes) { return std::make_unique<LinkedListMemoryAllocator>(nbBytes); }, StatsFragmentation<LinkedListMemoryAllocator>, false },
+			{ "LLMA segregated", [](size_t nbBytes) { return std::make_unique<LinkedListMemoryAllocator>(nbBytes, eFreeListMode::Segregated); }, StatsFragmentation<LinkedListMemoryAllocator>, false },
+			{ "LLMA best fit", [](size_t nbBytes) { return std::make_unique<LinkedListMemoryAllocator>(nbBytes, eFreeListMode::AddressOrdered, ePlacement::BestFit); }, StatsFragmentation<LinkedListMemoryAllocator>, false },
+			{ "DLLMA lazy", [](size_t nbBytes) { return std::make_unique<DoubleLinkedListMemoryAllocator>(nbBytes); }, StatsFragmentation<DoubleLinkedListMemoryAllocator>, false },
+			{ "DLLMA eager", [](size_t nbBytes) { return std::make_unique<DoubleLinkedListMemoryAllocator>(nbBytes, eCoalescing::Eager); }, StatsFragmentation<DoubleLinkedListMemoryAllocator>, false },
+			{ "DLLMA best fit", [](size_t nbBytes) { return std::make_unique<DoubleLinkedListMemoryAllocator>(nbBytes, eCoalescing::Eager, ePlacement::BestFit); }, StatsFragmentation<DoubleLinkedListMemoryAllocator>, false },
+			{ "TLSFMA", [](size_t nbBytes) { return std::make_unique<TLSFMemoryAllocator>(nbBytes); }, Fragmentation<TLSFMemoryAllocator>, false },
+			{ "ThreadCachedMA", [](size_t nbBytes) { return std::make_unique<ThreadCachedMemoryAllocator>(nbBytes); }, nullptr, true },
+		};
+	}
+
+#pragma region Workloads
+	enum class eFreeOrder
+	{
+		Lifo,
+		Fifo,
+		Random,
+	};
+
+	size_t UniformSize(std::mt19937& rng)
+	{
+		return std::uniform_int_distribution<size_t>{ 8, 512 }(rng);
+	}
+
+	// pareto distributed, most requests are tiny but a few are huge
+	size_t PowerLawSize(std::mt19937& rng)
+	{
+		const double u = std::uniform_real_distribution<double>{ 1e-9, 1.0 }(rng);
+		return std::min(size_t(8.0 * std::pow(u, -1.0 / 1.1)), size_t(64) << 10);
+	}
+
+	// generated up front as a trace, so every allocator replays the exact same sequence
+	std::vector<TraceRecord> GenerateWorkload(const Settings& settings, size_t(*pSize)(std::mt19937&), eFreeOrder order)
+	{
+		std::mt19937 rng{ settings.seed };
+		std::vector<TraceRecord> records;
+		records.reserve(settings.operations + settings.liveAmount);
+		std::deque<uint64_t> live;
+		uint64_t nextId = 0;
+
+		auto release = [&]()
+		{
+			size_t idx = 0;
+			if (order == eFreeOrder::Lifo)
+				idx = live.size() - 1;
+			else if (order == eFreeOrder::Random)
+				idx = std::uniform_int_distribution<size_t>{ 0, live.size() - 1 }(rng);
+			records.push_back({ live[idx], 0, 0, 0, eTraceOperation::Release, 0 });
+			live[idx] = live.back();
+			if (order == eFreeOrder::Fifo)
+				live.pop_front();
+			else
+				live.pop_back();
+		};
+
+		while (records.size() < settings.operations)
+		{
+			// hovers around the live amount once it is reached
+			const bool isAcquire = live.empty() || (live.size() < settings.liveAmount && (live.size() < settings.liveAmount / 2 || rng() % 2));
+			if (isAcquire)
+			{
+				records.push_back({ nextId, pSize(rng), 0, 0, eTraceOperation::Acquire, 0 });
+				live.push_back(nextId++);
+			}
+			else
+				release();
+		}
+		while (!live.empty())
+			release();
+		return records;
+	}
+#pragma endregion
+
+#pragma region Runs
+	// single threaded replay, multi threaded traces are replayed in record order
+	Result Replay(MemoryAllocator& allocator, const std::vector<TraceRecord>& records, size_t idAmount, bool isMeasuringLatency, const std::function<double(const MemoryAllocator&)>& fragmentation)
+	{
+		Result result{};
+		std::vector<void*> pointers(idAmount, nullptr);
+		if (isMeasuringLatency)
+			result.latencies.reserve(records.size());
+
+		const size_t sampleInterval = std::max(records.size() / 64, size_t(1));
+		const Clock::time_point start = Clock::now();
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			const TraceRecord& record = records[i];
+			const Clock::time_point opStart = isMeasuringLatency ? Clock::now() : Clock::time_point{};
+			if (record.operation == eTraceOperation::Acquire)
+			{
+				try
+				{
+					char* pData = static_cast<char*>(allocator.Acquire(size_t(record.size)));
+					pData[0] = char(i);
+					pointers[record.id] = pData;
+				}
+				catch (const std::exception&)
+				{
+					result.failures++;
+				}
+			}
+			else if (pointers[record.id])
+			{
+				allocator.Release(pointers[record.id]);
+				pointers[record.id] = nullptr;
+			}
+
+			if (isMeasuringLatency)
+			{
+				result.latencies.push_back(uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - opStart).count()));
+				if (fragmentation && i % sampleInterval == 0)
+					result.peakFragmentation = std::max(result.peakFragmentation, fragmentation(allocator));
+			}
+		}
+		result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		result.operations = records.size();
+
+		// traces may end with blocks still alive
+		for (void* pData : pointers)
+			allocator.Release(pData);
+		return result;
+	}
+
+	// one thread acquires, the other releases what it receives through a bounded queue
+	Result ProducerConsumer(MemoryAllocator& allocator, const Settings& settings, bool isMeasuringLatency)
+	{
+		enum { QueueSize = 1024 };
+		std::vector<std::atomic<void*>> queue(QueueSize);
+		std::atomic<size_t> head{ 0 };
+		std::atomic<size_t> tail{ 0 };
+		const size_t amount = settings.operations / 2;
+		Result consumerResult{};
+		Result result{};
+
+		auto record = [isMeasuringLatency](Result& r, Clock::time_point opStart)
+		{
+			if (isMeasuringLatency)
+				r.latencies.push_back(uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - opStart).count()));
+		};
+
+		const Clock::time_point start = Clock::now();
+		std::thread consumer{ [&]()
+		{
+			for (size_t i = 0; i < amount; i++)
+			{
+				size_t idx = tail.load(std::memory_order_relaxed);
+				while (idx == head.load(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				void* pData = queue[idx % QueueSize].load(std::memory_order_relaxed);
+				tail.store(idx + 1, std::memory_order_release);
+				const Clock::time_point opStart = isMeasuringLatency ? Clock::now() : Clock::time_point{};
+				allocator.Release(pData);
+				record(consumerResult, opStart);
+			}
+		} };
+
+		std::mt19937 rng{ settings.seed };
+		for (size_t i = 0; i < amount; i++)
+		{
+			const size_t nbBytes = UniformSize(rng);
+			const Clock::time_point opStart = isMeasuringLatency ? Clock::now() : Clock::time_point{};
+			void* pData = nullptr;
+			try
+			{
+				pData = allocator.Acquire(nbBytes);
+			}
+			catch (const std::exception&)
+			{
+				result.failures++;
+			}
+			record(result, opStart);
+
+			const size_t idx = head.load(std::memory_order_relaxed);
+			while (idx - tail.load(std::memory_order_acquire) == QueueSize)
+				std::this_thread::yield();
+			queue[idx % QueueSize].store(pData, std::memory_order_relaxed);
+			head.store(idx + 1, std::memory_order_release);
+		}
+		consumer.join();
+
+		result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		result.operations = amount * 2;
+		result.latencies.insert(result.latencies.end(), consumerResult.latencies.begin(), consumerResult.latencies.end());
+		return result;
+	}
+#pragma endregion
+
+	uint32_t Percentile(std::vector<uint32_t>& latencies, double percentile)
+	{
+		if (latencies.empty())
+			return 0;
+		const size_t idx = std::min(size_t(percentile * double(latencies.size())), latencies.size() - 1);
+		std::nth_element(latencies.begin(), latencies.begin() + idx, latencies.end());
+		return latencies[idx];
+	}
+
+	void Print(const std::string& workload, const char* name, const Result& throughput, Result& latency)
+	{
+		char line[256];
+		char fragmentation[16] = "n/a";
+		if (latency.peakFragmentation >= 0.0)
+			snprintf(fragmentation, sizeof(fragmentation), "%.1f%%", latency.peakFragmentation * 100.0);
+		snprintf(line, sizeof(line), "%-20s %-16s %10.2f %8u %8u %8u %8s %8zu",
+			workload.c_str(), name, double(throughput.operations) / throughput.seconds / 1e6,
+			Percentile(latency.latencies, 0.5), Percentile(latency.latencies, 0.99), Percentile(latency.latencies, 0.999),
+			fragmentation, throughput.failures);
+		std::cout << line << std::endl;
+	}
+
+	// throughput and latency come from separate runs on fresh allocators, so the
+	// clock reads and fragmentation samples do not show up in the throughput
+	void RunTrace(const Settings& settings, const std::string& workload, const std::vector<TraceRecord>& records, size_t idAmount)
+	{
+		for (const Candidate& candidate : CreateCandidates())
+		{
+			std::unique_ptr<MemoryAllocator> pAllocator = candidate.create(settings.arenaBytes);
+			const Result throughput = Replay(*pAllocator, records, idAmount, false, nullptr);
+			pAllocator = candidate.create(settings.arenaBytes);
+			Result latency = Replay(*pAllocator, records, idAmount, true, candidate.fragmentation);
+			Print(workload, candidate.name, throughput, latency);
+		}
+	}
+
+	void RunProducerConsumer(const Settings& settings)
+	{
+		for (const Candidate& candidate : CreateCandidates())
+		{
+			Result results[2];
+			for (int i = 0; i < 2; i++)
+			{
+				std::unique_ptr<MemoryAllocator> pAllocator = candidate.create(settings.arenaBytes);
+				if (candidate.isThreadSafe)
+					results[i] = ProducerConsumer(*pAllocator, settings, i == 1);
+				else
+				{
+					LockedMemoryAllocator locked{ *pAllocator };
+					results[i] = ProducerConsumer(locked, settings, i == 1);
+				}
+			}
+			Print("producer-consumer", candidate.name, results[0], results[1]);
+		}
+	}
+
+	Settings ParseSettings(int argc, char* argv[])
+	{
+		Settings settings{};
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string arg{ argv[i] };
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--ops" && hasValue)
+				settings.operations = size_t(std::strtoull(argv[++i], nullptr, 10));
+			else if (arg == "--live" && hasValue)
+				settings.liveAmount = std::max(size_t(std::strtoull(argv[++i], nullptr, 10)), size_t(1));
+			else if (arg == "--seed" && hasValue)
+				settings.seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+			else if (arg == "--arena" && hasValue)
+				settings.arenaBytes = size_t(std::strtoull(argv[++i], nullptr, 10)) << 20;
+			else
+				settings.tracePaths.push_back(arg);
+		}
+		return settings;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const Settings settings = ParseSettings(argc, argv);
+	std::cout << "ops " << settings.operations << ", live " << settings.liveAmount << ", seed " << settings.seed << ", arena " << (settings.arenaBytes >> 20) << " MiB" << std::endl;
+	std::cout << "workload             allocator          Mops/s  p50(ns)  p99(ns) p999(ns) peakfrag failures" << std::endl;
+
+	struct Workload
+	{
+		const char* name;
+		size_t(*pSize)(std::mt19937&);
+		eFreeOrder order;
+	};
+	const Workload workloads[] = {
+		{ "uniform lifo", UniformSize, eFreeOrder::Lifo },
+		{ "uniform fifo", UniformSize, eFreeOrder::Fifo },
+		{ "uniform random", UniformSize, eFreeOrder::Random },
+		{ "power-law random", PowerLawSize, eFreeOrder::Random },
+	};
+	for (const Workload& workload : workloads)
+	{
+		std::vector<TraceRecord> records = GenerateWorkload(settings, workload.pSize, workload.order);
+		const size_t idAmount = CompactTraceIds(records);
+		RunTrace(settings, workload.name, records, idAmount);
+	}
+	RunProducerConsumer(settings);
+
+	for (const std::string& path : settings.tracePaths)
+	{
+		try
+		{
+			std::vector<TraceRecord> records = LoadTrace(path);
+			const size_t idAmount = CompactTraceIds(records);
+			RunTrace(settings, path, records, idAmount);
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << path << ": " << e.what() << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,239 @@
+// Ticks the brain's behavior tree as an Elite node graph and as a FlatBehaviorTree and prints
+// the cost of a tick. Leaves are stand-ins that read one flag per conditional and one state per
+// action from a set of frames generated up front, so both trees see the same inputs and only the
+// walk is measured. The leaves they reach are hashed to check that both trees take the same paths.
+// usage: BehaviorTreeBenchmark [--ticks n] [--frames n] [--true p] [--running p] [--failure p] [--runs n] [--seed n]
+#include "../BrainTreeShape.h"
+#include "../FlatBehaviorTree.h"
+#include "EBlackboard.h"
+#include "EBehaviorTree.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using Elite::BehaviorState;
+
+	enum : size_t { ConditionalAmount = 24, ActionAmount = 18 };
+
+	struct Frame
+	{
+		std::array<bool, ConditionalAmount> flags;
+		std::array<BehaviorState, ActionAmount> states;
+	};
+
+	const Frame* g_pFrame = nullptr;
+	uint64_t g_Trace = 0;
+
+	template<size_t Id>
+	bool Flag(Elite::Blackboard*)
+	{
+		g_Trace = g_Trace * 31 + Id;
+		return g_pFrame->flags[Id];
+	}
+
+	template<size_t Id>
+	BehaviorState Act(Elite::Blackboard*)
+	{
+		g_Trace = g_Trace * 31 + ConditionalAmount + Id;
+		return g_pFrame->states[Id];
+	}
+
+	struct Settings
+	{
+		size_t ticks = 1000000;
+		size_t frames = 1024;
+		double trueChance = 0.3;
+		// the rest of the actions succeed
+		double runningChance = 0.1;
+		double failureChance = 0.1;
+		size_t runs = 5;
+		uint32_t seed = 1;
+	};
+
+	// the brain's tree with one stand-in per function it uses
+	FlatBehaviorTree::Desc BrainShape()
+	{
+		using Tree = FlatBehaviorTree;
+		BrainTreeLeaves leaves;
+		leaves.isInPurgeZone = Tree::Conditional(Flag<0>);
+		leaves.isInCombat = Tree::Conditional(Flag<1>);
+		leaves.enemyInRange = Tree::Conditional(Flag<2>);
+		leaves.hasPistol = Tree::Conditional(Flag<3>);
+		leaves.knewEnemy = Tree::Conditional(Flag<4>);
+		leaves.falseCondition = Tree::Conditional(Flag<5>);
+		leaves.unknownItemInSight = Tree::Conditional(Flag<6>);
+		leaves.isStuck = Tree::Conditional(Flag<7>);
+		leaves.hasLowHealth = Tree::Conditional(Flag<8>);
+		leaves.knowsMedKit = Tree::Conditional(Flag<9>);
+		leaves.targetCloserThanHouse = Tree::Conditional(Flag<10>);
+		leaves.hasNotLowHealth = Tree::Conditional(Flag<11>);
+		leaves.hasLowEnergy = Tree::Conditional(Flag<12>);
+		leaves.knowsFood = Tree::Conditional(Flag<13>);
+		leaves.hasNotLowEnergy = Tree::Conditional(Flag<14>);
+		leaves.hasNoPistol = Tree::Conditional(Flag<15>);
+		leaves.knowsPistol = Tree::Conditional(Flag<16>);
+		leaves.isInHouse = Tree::Conditional(Flag<17>);
+		leaves.houseIsNotExplored = Tree::Conditional(Flag<18>);
+		leaves.hasUnknownItem = Tree::Conditional(Flag<19>);
+		leaves.hasFreeInventorySlot = Tree::Conditional(Flag<20>);
+		leaves.knowsHouse = Tree::Conditional(Flag<21>);
+		leaves.enemyInSight = Tree::Conditional(Flag<22>);
+		leaves.hasFullStamina = Tree::Conditional(Flag<23>);
+		leaves.setRunMode = Tree::Action(Act<0>);
+		leaves.setTargetPurgeZoneEscape = Tree::Action(Act<1>);
+		leaves.setSeek = Tree::Action(Act<2>);
+		leaves.initializeFlee = Tree::Action(Act<3>);
+		leaves.setMovementEnemyCenter = Tree::Action(Act<4>);
+		leaves.setFlee = Tree::Action(Act<5>);
+		leaves.setMovementUnknownItem = Tree::Action(Act<6>);
+		leaves.setMovementExplore = Tree::Action(Act<7>);
+		leaves.setMovementMedKit = Tree::Action(Act<8>);
+		leaves.setMovementFood = Tree::Action(Act<9>);
+		leaves.setMovementPistol = Tree::Action(Act<10>);
+		leaves.setMovementNearestUnexploredCorner = Tree::Action(Act<11>);
+		leaves.setMovementItem = Tree::Action(Act<12>);
+		leaves.setMovementHouse = Tree::Action(Act<13>);
+		leaves.setOrientationNearestEnemy = Tree::Action(Act<14>);
+		leaves.setRotateIntoFront = Tree::Action(Act<15>);
+		leaves.setForwardScanning = Tree::Action(Act<16>);
+		leaves.setFullScanning = Tree::Action(Act<17>);
+		return BrainTreeShape(leaves);
+	}
+
+	Elite::IBehavior* BuildGraph(const FlatBehaviorTree::Desc& desc)
+	{
+		switch (desc.type)
+		{
+		case eFlatBehavior::Sequence:
+		case eFlatBehavior::Selector:
+		{
+			std::vector<Elite::IBehavior*> children;
+			for (const FlatBehaviorTree::Desc& child : desc.children)
+				children.push_back(BuildGraph(child));
+			if (desc.type == eFlatBehavior::Sequence)
+				return new Elite::BehaviorSequence{ children };
+			return new Elite::BehaviorSelector{ children };
+		}
+		case eFlatBehavior::Conditional:
+			return new Elite::BehaviorConditional{ desc.conditional };
+		default:
+			return new Elite::BehaviorAction{ desc.action };
+		}
+	}
+
+	struct Result
+	{
+		double nsPerTick = 0.0;
+		uint64_t trace = 0;
+	};
+
+	// fastest of the runs, the trace of the first
+	template<typename TTick>
+	Result Run(const Settings& settings, const std::vector<Frame>& frames, TTick tick)
+	{
+		Result result{};
+		for (size_t run = 0; run < settings.runs; run++)
+		{
+			g_Trace = 0;
+			const Clock::time_point start = Clock::now();
+			for (size_t i = 0; i < settings.ticks; i++)
+			{
+				g_pFrame = &frames[i % frames.size()];
+				tick();
+			}
+			const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()) / double(settings.ticks);
+			if (run == 0)
+			{
+				result.nsPerTick = ns;
+				result.trace = g_Trace;
+			}
+			result.nsPerTick = std::min(result.nsPerTick, ns);
+		}
+		return result;
+	}
+
+	Settings ParseSettings(int argc, char* argv[])
+	{
+		Settings settings{};
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string arg{ argv[i] };
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--ticks" && hasValue)
+				settings.ticks = std::max(size_t(std::strtoull(argv[++i], nullptr, 10)), size_t(1));
+			else if (arg == "--frames" && hasValue)
+				settings.frames = std::max(size_t(std::strtoull(argv[++i], nullptr, 10)), size_t(1));
+			else if (arg == "--true" && hasValue)
+				settings.trueChance = std::min(std::max(std::strtod(argv[++i], nullptr), 0.0), 1.0);
+			else if (arg == "--running" && hasValue)
+				settings.runningChance = std::min(std::max(std::strtod(argv[++i], nullptr), 0.0), 1.0);
+			else if (arg == "--failure" && hasValue)
+				settings.failureChance = std::min(std::max(std::strtod(argv[++i], nullptr), 0.0), 1.0);
+			else if (arg == "--runs" && hasValue)
+				settings.runs = std::max(size_t(std::strtoull(argv[++i], nullptr, 10)), size_t(1));
+			else if (arg == "--seed" && hasValue)
+				settings.seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+			else
+				std::cerr << "ignoring argument " << arg << std::endl;
+		}
+		settings.failureChance = std::min(settings.failureChance, 1.0 - settings.runningChance);
+		return settings;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const Settings settings = ParseSettings(argc, argv);
+
+	std::mt19937 rng{ settings.seed };
+	std::bernoulli_distribution isTrue{ settings.trueChance };
+	std::uniform_real_distribution<double> stateRoll{ 0.0, 1.0 };
+	std::vector<Frame> frames(settings.frames);
+	for (Frame& frame : frames)
+	{
+		for (bool& flag : frame.flags)
+			flag = isTrue(rng);
+		for (BehaviorState& state : frame.states)
+		{
+			const double roll = stateRoll(rng);
+			if (roll < settings.runningChance)
+				state = BehaviorState::Running;
+			else if (roll < settings.runningChance + settings.failureChance)
+				state = BehaviorState::Failure;
+			else
+				state = BehaviorState::Success;
+		}
+	}
+
+	const FlatBehaviorTree::Desc shape = BrainShape();
+	Elite::BehaviorTree graph{ new Elite::Blackboard{}, BuildGraph(shape) };
+	FlatBehaviorTree flat{ new Elite::Blackboard{}, shape };
+
+	std::cout << "ticks " << settings.ticks << ", frames " << settings.frames << ", true " << settings.trueChance << ", running " << settings.runningChance << ", failure " << settings.failureChance << ", runs " << settings.runs << ", seed " << settings.seed << ", leaves " << flat.GetLeafAmount() << std::endl;
+	std::cout << "tree              ns/tick  speedup  trace" << std::endl;
+
+	const Result graphResult = Run(settings, frames, [&graph]() { graph.Update(); });
+	const Result flatResult = Run(settings, frames, [&flat]() { flat.Update(); });
+
+	char line[128];
+	snprintf(line, sizeof(line), "%-16s %8.2f %8.2f  %016llx", "elite graph", graphResult.nsPerTick, 1.0, (unsigned long long)graphResult.trace);
+	std::cout << line << std::endl;
+	snprintf(line, sizeof(line), "%-16s %8.2f %8.2f  %016llx", "flat", flatResult.nsPerTick, graphResult.nsPerTick / flatResult.nsPerTick, (unsigned long long)flatResult.trace);
+	std::cout << line << std::endl;
+
+	if (graphResult.trace != flatResult.trace)
+	{
+		std::cout << "the trees took different paths" << std::endl;
+		return 1;
+	}
+	return 0;
+}
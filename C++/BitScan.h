@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#if defined (_MSC_VER)
+#include <intrin.h>
+#endif
+
+// index of the lowest set bit, mask must not be 0
+inline uint32_t FindFirstSet(uint32_t mask)
+{
+#if defined (_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return uint32_t(idx);
+#else
+	return uint32_t(__builtin_ctz(mask));
+#endif
+}
+
+inline uint32_t FindFirstSet(uint64_t mask)
+{
+#if defined (_MSC_VER) && defined (_WIN64)
+	unsigned long idx;
+	_BitScanForward64(&idx, mask);
+	return uint32_t(idx);
+#elif defined (_MSC_VER)
+	const uint32_t low = uint32_t(mask);
+	return low ? FindFirstSet(low) : 32 + FindFirstSet(uint32_t(mask >> 32));
+#else
+	return uint32_t(__builtin_ctzll(mask));
+#endif
+}
+
+// index of the highest set bit (floor of log2), value must not be 0
+inline uint32_t FindLastSet(size_t value)
+{
+#if defined (_MSC_VER)
+	unsigned long idx;
+#if defined (_WIN64)
+	_BitScanReverse64(&idx, value);
+#else
+	_BitScanReverse(&idx, value);
+#endif
+	return uint32_t(idx);
+#else
+	return uint32_t(std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(value));
+#endif
+}
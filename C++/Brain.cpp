@@ -3,11 +3,14 @@
 #include <IExamInterface.h>
 #include "InventoryManager.h"
 #include <algorithm>
+#include <cassert>
 #include "HelperFunctions.h"
 #include "BlackboardDefinitions.h"
 #include "BehaviorDefinitions.h"
 #include "EBlackboard.h"
 #include "EBehaviorTree.h"
+#include "FlatBehaviorTree.h"
+#include "BrainTreeShape.h"
 
 using namespace Elite;
 
@@ -24,10 +27,7 @@ Brain::Brain()
 	, m_pRotateIntoVision{ nullptr }
 	, m_pMovement{ nullptr }
 	, m_pOrientation{ nullptr }
-	, m_KnownPistols{ }
-	, m_KnownGarbage{ }
-	, m_KnownMedKits{ }
-	, m_KnownFood{ }
+	, m_Items{ }
 	, m_CurrentHouseIdx{ -1 }
 	, m_StuckCoolDown{ 0.f }
 	, m_StuckProgress{ 0.f }
@@ -127,7 +127,7 @@ void Brain::DrawDebug() const
 	//*/
 
 	// Houses
-	for (size_t i = 0; i < m_Houses.size(); i++)
+	for (size_t i = 0; i < m_Houses.GetAmount(); i++)
 	{
 		m_pInterface->Draw_Polygon(m_Houses[i].Corners, 4, { 0, 0, 0 });
 		for (size_t j = 0; j < 4; j++)
@@ -139,25 +139,30 @@ void Brain::DrawDebug() const
 
 	// Items
 	const float itemSize = 1.5f;
-	for (size_t i = 0; i < m_KnownMedKits.size(); i++)
-		m_pInterface->Draw_SolidCircle(m_KnownMedKits[i], itemSize, { 0, 0 }, { 1, 0, 0 });
-	for (size_t i = 0; i < m_KnownFood.size(); i++)
-		m_pInterface->Draw_SolidCircle(m_KnownFood[i], itemSize, { 0, 0 }, { 0, 1, 0 });
-	for (size_t i = 0; i < m_KnownPistols.size(); i++)
-		m_pInterface->Draw_SolidCircle(m_KnownPistols[i], itemSize, { 0, 0 }, { 0, 0, 1 });
-	for (size_t i = 0; i < m_KnownGarbage.size(); i++)
-		m_pInterface->Draw_SolidCircle(m_KnownGarbage[i], itemSize, { 0, 0 }, { 1, 0.5, 0 });
-	for (size_t i = 0; i < m_UnknownItems.size(); i++)
-		m_pInterface->Draw_SolidCircle(m_UnknownItems[i], itemSize, { 0, 0 }, { 1, 0, 1 });
+	m_Items.ForEach([this, itemSize](const Vector2& location, eItemType type)
+	{
+		Vector3 color{ 1, 0, 1 };
+		switch (type)
+		{
+		case eItemType::MEDKIT: color = { 1, 0, 0 }; break;
+		case eItemType::FOOD: color = { 0, 1, 0 }; break;
+		case eItemType::PISTOL: color = { 0, 0, 1 }; break;
+		case eItemType::GARBAGE: color = { 1, 0.5, 0 }; break;
+		default: break;
+		}
+		m_pInterface->Draw_SolidCircle(location, itemSize, { 0, 0 }, color);
+	});
 	//*/
 }
 
 SteeringPlugin_Output Brain::Update(const float dt)
 {
+	assert(m_Board.MatchesPublished(*m_pBlackboard) && "a behavior wrote a key bound to a BrainBlackboard slot");
 	m_RunMode = false;
 	m_IsStuck = false;
-	m_Forward = RotateVector({ 0.f,-1.f }, m_pInterface->Agent_GetInfo().Orientation);
 	m_pInventory->Update();
+	m_Perception.Capture(m_pInterface);
+	m_Forward = RotateVector({ 0.f,-1.f }, m_Perception.GetAgent().Orientation);
 	HandleStuck(dt);
 	HandleFovEntities();
 	HandleFovHouses();
@@ -166,6 +171,7 @@ SteeringPlugin_Output Brain::Update(const float dt)
 	UpdateHouses();
 	UpdateItemTargets();
 	UpdateBlackboard();
+	m_Board.Publish(*m_pBlackboard);
 	m_pBehaviorTree->Update();
 
 	return CalculateSteering(dt);
@@ -187,21 +193,10 @@ SteeringPlugin_Output Brain::CalculateSteering(const float dt) const
 #pragma region HOUSES --------------------------------------------------------------------------------
 void Brain::HandleFovHouses()
 {
-	auto agentPos = m_pInterface->Agent_GetInfo().Position;
-	auto houses = GetHousesInFOV();
+	const auto houses = m_Perception.GetHouses();
 	for (size_t j = 0; j < houses.size(); j++)
 	{
-		int idx = -1;
-		for (int i = 0; i < (int)m_Houses.size(); i++)
-		{
-			if (houses[j].Center == m_Houses[i].Center)
-			{
-				idx = i;
-				break;
-			}
-		}
-
-		if (idx == -1)
+		if (m_Houses.Find(houses[j].Center) == -1)
 		{
 			HouseInfoExtended newHouse{};
 			newHouse.Center = houses[j].Center;
@@ -215,66 +210,64 @@ void Brain::HandleFovHouses()
 			newHouse.Corners[2] = newHouse.Center + Vector2{ half.x, half.y };
 			newHouse.Corners[3] = newHouse.Center + Vector2{ half.x, -half.y };
 
-			m_Houses.push_back(newHouse);
+			m_Houses.Add(newHouse);
 		}
 	}
 }
 
 void Brain::UpdateHouses()
 {
-	auto agentPos = m_pInterface->Agent_GetInfo().Position;
-	bool isInHouse = m_pInterface->Agent_GetInfo().IsInHouse;
+	const auto& agentPos = m_Perception.GetAgent().Position;
+	bool isInHouse = m_Perception.GetAgent().IsInHouse;
 
-	bool hasHouse = false;
-
-	for (size_t i = 0; i < m_Houses.size(); i++)
+	if (isInHouse)
 	{
-		if (isInHouse && InBounds(agentPos, m_Houses[i].Center, m_Houses[i].Size))
+		m_Houses.ForEachContaining(agentPos, [this](int i)
 		{
 			if (i != m_CurrentHouseIdx)
 			{
 				m_CurrentHouseIdx = i;
-				if (m_pInterface->World_GetStats().NumItemsPickUp - m_Houses[m_CurrentHouseIdx].ItemsPickedUp > m_HouseCoolDownItemAmount)
+				if (m_Perception.GetItemsPickedUp() - m_Houses[m_CurrentHouseIdx].ItemsPickedUp > m_HouseCoolDownItemAmount)
 				{
 					m_Houses[i].CornersSeen[0] = false;
 					m_Houses[i].CornersSeen[1] = false;
 					m_Houses[i].CornersSeen[2] = false;
 					m_Houses[i].CornersSeen[3] = false;
 				}
-				m_Houses[m_CurrentHouseIdx].ItemsPickedUp = m_pInterface->World_GetStats().NumItemsPickUp;
+				m_Houses.SetItemsPickedUp(m_CurrentHouseIdx, m_Perception.GetItemsPickedUp());
 			}
 			UpdateCurrentHouse(i);
-		}
+		});
 	}
 
-	if (!isInHouse && m_WasInHouse)
+	if (!isInHouse && m_WasInHouse && m_CurrentHouseIdx != -1)
 	{
-		m_Houses[m_CurrentHouseIdx].ItemsPickedUp = m_pInterface->World_GetStats().NumItemsPickUp;
+		m_Houses.SetItemsPickedUp(m_CurrentHouseIdx, m_Perception.GetItemsPickedUp());
 		m_CurrentHouseIdx = -1;
 	}
 
 	m_WasInHouse = isInHouse;
 
 	int idx = GetNextHouse();
-	m_pBlackboard->ChangeData(bb_KnowsHouse, idx != -1);
+	m_Board.Set<BrainSlot::KnowsHouse>(idx != -1);
 	if (idx != -1)
 	{
 		size_t buffer;
 		Vector2 corner = GetNearestCorner(agentPos, m_Houses[idx], buffer, false);
-		m_pBlackboard->ChangeData(bb_HouseCloserThanExploration, agentPos.DistanceSquared(m_Houses[idx].Center) < agentPos.DistanceSquared(m_ExplorationTarget));
-		m_pBlackboard->ChangeData(bb_HouseLocation, corner);
-		m_pBlackboard->ChangeData(bb_NextHouseIsExplored, m_Houses[idx].CornersSeen[0] && m_Houses[idx].CornersSeen[1] && m_Houses[idx].CornersSeen[2] && m_Houses[idx].CornersSeen[3]);
+		m_Board.Set<BrainSlot::HouseCloserThanExploration>(agentPos.DistanceSquared(m_Houses[idx].Center) < agentPos.DistanceSquared(m_ExplorationTarget));
+		m_Board.Set<BrainSlot::HouseLocation>(corner);
+		m_Board.Set<BrainSlot::NextHouseIsExplored>(m_Houses[idx].CornersSeen[0] && m_Houses[idx].CornersSeen[1] && m_Houses[idx].CornersSeen[2] && m_Houses[idx].CornersSeen[3]);
 	}
 }
 
 void Brain::UpdateCurrentHouse(const size_t idx)
 {
-	const auto& agent = m_pInterface->Agent_GetInfo();
+	const auto& agent = m_Perception.GetAgent();
 	float right = agent.Orientation - agent.FOV_Angle / 2.f;
 	float left = agent.Orientation + agent.FOV_Angle / 2.f;
 
 
-	m_pBlackboard->ChangeData(bb_IsInHouse, agent.IsInHouse);
+	m_Board.Set<BrainSlot::IsInHouse>(agent.IsInHouse);
 
 	HouseInfoExtended& house = m_Houses[idx];
 
@@ -290,7 +283,7 @@ void Brain::UpdateCurrentHouse(const size_t idx)
 			continue;
 
 		float disSq = agent.Position.DistanceSquared(house.Corners[j]);
-		if (disSq < powf(m_pInterface->Agent_GetInfo().FOV_Range, 2.f))
+		if (disSq < powf(agent.FOV_Range, 2.f))
 		{
 
 			auto cornerDir = (house.Corners[j] - agent.Position).GetNormalized();
@@ -299,7 +292,7 @@ void Brain::UpdateCurrentHouse(const size_t idx)
 			if (AngleIsInbetweenInDegree(ToDegrees(angle), ToDegrees(left), ToDegrees(right)))
 				house.CornersSeen[j] = true;
 		}
-		if (disSq < powf(m_pInterface->Agent_GetInfo().GrabRange, 2.f))
+		if (disSq < powf(agent.GrabRange, 2.f))
 			house.CornersSeen[j] = true;
 
 		if (!house.CornersSeen[j])
@@ -313,128 +306,98 @@ void Brain::UpdateCurrentHouse(const size_t idx)
 		}
 	}
 
-	m_pBlackboard->ChangeData(bb_HouseIsExplored, allExplored);
-	m_pBlackboard->ChangeData(bb_NearestUnexploredCorner, corner);
+	m_Board.Set<BrainSlot::HouseIsExplored>(allExplored);
+	m_Board.Set<BrainSlot::NearestUnexploredCorner>(corner);
 }
 
 void Brain::UpdateExplorationTarget()
 {
-	const auto& world = m_pInterface->World_GetInfo();
+	const auto& world = m_Perception.GetWorld();
 	const auto half = world.Dimensions / 2.f;
 
-	const auto& agent = m_pInterface->Agent_GetInfo();
+	const auto& agent = m_Perception.GetAgent();
 
 	if (m_ExplorationTarget == m_StuckTarget)
 	{
 		m_ExplorationTarget = { randomFloat(world.Dimensions.x), randomFloat(world.Dimensions.y) };
 		m_ExplorationTarget += world.Center - half;
-		m_pBlackboard->ChangeData(bb_ExplorationTarget, m_ExplorationTarget);
+		m_Board.Set<BrainSlot::ExplorationTarget>(m_ExplorationTarget);
 	}
-	else if (agent.Position.DistanceSquared(m_ExplorationTarget) < powf(m_pInterface->Agent_GetInfo().FOV_Range, 2.f))
+	else if (agent.Position.DistanceSquared(m_ExplorationTarget) < powf(agent.FOV_Range, 2.f))
 	{
 		m_ExploredTargets.push_back(m_ExplorationTarget);
 		m_ExplorationTarget = { randomFloat(world.Dimensions.x), randomFloat(world.Dimensions.y) };
 		m_ExplorationTarget += world.Center - half;
-		m_pBlackboard->ChangeData(bb_ExplorationTarget, m_ExplorationTarget);
+		m_Board.Set<BrainSlot::ExplorationTarget>(m_ExplorationTarget);
 	}
 }
 
 void Brain::UpdateItemTargets()
 {
-	const auto agentPos = m_pInterface->Agent_GetInfo().Position;
+	const auto& agentPos = m_Perception.GetAgent().Position;
 
 	float nearestSq = FLT_MAX;
-	int nearestIdx = -1;
 	eItemType nearestType = eItemType::RANDOM_DROP;
 
-	auto GetNearest = [&nearestSq, &nearestIdx, &nearestType](const std::vector<Vector2>& v, const Vector2& pos, const eItemType type) -> Vector2
+	auto GetNearest = [this, &nearestSq, &nearestType](const Vector2& pos, const eItemType type) -> Vector2
 	{
-		int idx = -1;
-		float minSq = FLT_MAX;
-		for (int i = 0; i < int(v.size()); i++)
-		{
-			float disSq = pos.DistanceSquared(v[i]);
-			if (disSq < minSq)
-			{
-				minSq = disSq;
-				idx = i;
-			}
-		}
-		if (minSq < nearestSq)
+		Vector2 nearest;
+		if (!m_Items.GetNearest(pos, type, nearest))
+			return ZeroVector2;
+
+		float disSq = pos.DistanceSquared(nearest);
+		if (disSq < nearestSq)
 		{
-			nearestSq = minSq;
-			nearestIdx = idx;
+			nearestSq = disSq;
 			nearestType = type;
 		}
-		return idx != -1 ? v[idx] : ZeroVector2;
+		return nearest;
 	};
 
-	m_pBlackboard->ChangeData(bb_KnowsFood, !m_KnownFood.empty());
-	m_pBlackboard->ChangeData(bb_KnowsPistol, !m_KnownPistols.empty());
-	m_pBlackboard->ChangeData(bb_KnowsMedKit, !m_KnownMedKits.empty());
-	m_pBlackboard->ChangeData(bb_KnowsGarbage, !m_KnownGarbage.empty());
+	m_Board.Set<BrainSlot::KnowsFood>(m_Items.GetAmount(eItemType::FOOD) != 0);
+	m_Board.Set<BrainSlot::KnowsPistol>(m_Items.GetAmount(eItemType::PISTOL) != 0);
+	m_Board.Set<BrainSlot::KnowsMedKit>(m_Items.GetAmount(eItemType::MEDKIT) != 0);
+	m_Board.Set<BrainSlot::KnowsGarbage>(m_Items.GetAmount(eItemType::GARBAGE) != 0);
 
-	m_pBlackboard->ChangeData(bb_NearestFood, GetNearest(m_KnownFood, agentPos, eItemType::FOOD));
-	m_pBlackboard->ChangeData(bb_NearestPistol, GetNearest(m_KnownPistols, agentPos, eItemType::PISTOL));
-	m_pBlackboard->ChangeData(bb_NearestMedKit, GetNearest(m_KnownMedKits, agentPos, eItemType::MEDKIT));
-	m_pBlackboard->ChangeData(bb_NearestGarbage, GetNearest(m_KnownGarbage, agentPos, eItemType::GARBAGE));
+	m_Board.Set<BrainSlot::NearestFood>(GetNearest(agentPos, eItemType::FOOD));
+	m_Board.Set<BrainSlot::NearestPistol>(GetNearest(agentPos, eItemType::PISTOL));
+	m_Board.Set<BrainSlot::NearestMedKit>(GetNearest(agentPos, eItemType::MEDKIT));
+	m_Board.Set<BrainSlot::NearestGarbage>(GetNearest(agentPos, eItemType::GARBAGE));
 
-	m_pBlackboard->ChangeData(bb_NearestItem, nearestType);
+	m_Board.Set<BrainSlot::NearestItem>(nearestType);
 
 	Vector2 item;
 	if (GetNearestUnknownItem(item))
 	{
-		m_pBlackboard->ChangeData(bb_HasUnknownItem, true);
-		m_pBlackboard->ChangeData(bb_NearestUnknownItem, item);
-		if (agentPos.DistanceSquared(item) < powf(m_pInterface->Agent_GetInfo().FOV_Range, 2.f))
-			m_pBlackboard->ChangeData(bb_UnknownItemInArea, true);
+		m_Board.Set<BrainSlot::HasUnknownItem>(true);
+		m_Board.Set<BrainSlot::NearestUnknownItem>(item);
+		if (agentPos.DistanceSquared(item) < powf(m_Perception.GetAgent().FOV_Range, 2.f))
+			m_Board.Set<BrainSlot::UnknownItemInArea>(true);
 	}
 	else
 	{
-		m_pBlackboard->ChangeData(bb_HasUnknownItem, false);
-		m_pBlackboard->ChangeData(bb_UnknownItemInArea, false);
+		m_Board.Set<BrainSlot::HasUnknownItem>(false);
+		m_Board.Set<BrainSlot::UnknownItemInArea>(false);
 	}
 }
 
 int Brain::GetNextHouse() const
 {
-	const auto agentPos = m_pInterface->Agent_GetInfo().Position;
-	const auto currentPickedUp = int(m_pInterface->World_GetStats().NumItemsPickUp);
-	float minDistanceSq = FLT_MAX;
-	int maxItemPassed = -1;
-	int idx = -1;
-	int idxNearest = -1;
-	for (size_t i = 0; i < m_Houses.size(); i++)
-	{
-		if (i == m_CurrentHouseIdx)
-			continue;
-		float distanceSq = agentPos.DistanceSquared(m_Houses[i].Center);
-		if (distanceSq < minDistanceSq)
-		{
-			minDistanceSq = distanceSq;
-			idxNearest = i;
-		}
-		int itemsPassed = int(currentPickedUp - m_Houses[i].ItemsPickedUp);
-		if (itemsPassed == maxItemPassed)
-		{
-			// Check if closest unvisited house
-			float otherSq = agentPos.DistanceSquared(m_Houses[idx].Center);
-			maxItemPassed = itemsPassed;
-			if (distanceSq < otherSq)
-				idx = i;
-		}
-		else if (itemsPassed > maxItemPassed)
-		{
-			maxItemPassed = itemsPassed;
-			idx = i;
-		}
-	}
+	const auto& agentPos = m_Perception.GetAgent().Position;
+	const auto currentPickedUp = m_Perception.GetItemsPickedUp();
+
+	// the house passed by the most picked up items, the closest of those on a tie
+	int idx = m_Houses.GetOldestVisited(agentPos, m_CurrentHouseIdx);
+	if (idx == -1)
+		return -1;
 
+	int maxItemPassed = currentPickedUp - m_Houses[idx].ItemsPickedUp;
 	if (maxItemPassed < m_HouseCoolDownItemAmount)
 		return -1;
 
 	if (maxItemPassed < currentPickedUp)
 	{
+		int idxNearest = m_Houses.GetNearest(agentPos, m_CurrentHouseIdx);
 		if (currentPickedUp - m_Houses[idxNearest].ItemsPickedUp > m_HouseCoolDownItemAmount)
 			idx = idxNearest;
 	}
@@ -461,24 +424,6 @@ Vector2 Brain::GetNearestCorner(const Vector2& pos, const HouseInfoExtended& hou
 
 	return house.Corners[idx];
 }
-vector<HouseInfo> Brain::GetHousesInFOV() const
-{
-	vector<HouseInfo> vHousesInFOV = {};
-
-	HouseInfo hi = {};
-	for (int i = 0;; ++i)
-	{
-		if (m_pInterface->Fov_GetHouseByIndex(i, hi))
-		{
-			vHousesInFOV.push_back(hi);
-			continue;
-		}
-
-		break;
-	}
-
-	return vHousesInFOV;
-}
 #pragma endregion
 
 #pragma region ENITIES -------------------------------------------------------------------------------
@@ -490,14 +435,14 @@ void Brain::HandleStuck(const float dt)
 		if (m_StuckCoolDown <= 0.f)
 		{
 			m_StuckTarget = { FLT_MAX, FLT_MAX };
-			m_pBlackboard->ChangeData(bb_StuckTarget, m_StuckTarget);
+			m_Board.Set<BrainSlot::StuckTarget>(m_StuckTarget);
 		}
 	}
 
-	if (m_LatestPosition.DistanceSquared(m_pInterface->Agent_GetInfo().Position) > powf(m_StuckDistance, 2.f))
+	if (m_LatestPosition.DistanceSquared(m_Perception.GetAgent().Position) > powf(m_StuckDistance, 2.f))
 	{
-		m_pBlackboard->ChangeData(bb_IsStuck, false);
-		m_LatestPosition = m_pInterface->Agent_GetInfo().Position;
+		m_Board.Set<BrainSlot::IsStuck>(false);
+		m_LatestPosition = m_Perception.GetAgent().Position;
 		m_StuckProgress = 0.f;
 		return;
 	}
@@ -510,19 +455,19 @@ void Brain::HandleStuck(const float dt)
 		m_StuckCoolDown = stuckCoolDown;
 		m_IsStuck = true;
 		m_StuckTarget = m_pMovement->GetTarget();
-		m_pBlackboard->ChangeData(bb_StuckTarget, m_StuckTarget);
-		m_pBlackboard->ChangeData(bb_IsStuck, true);
+		m_Board.Set<BrainSlot::StuckTarget>(m_StuckTarget);
+		m_Board.Set<BrainSlot::IsStuck>(true);
 		m_StuckProgress = 0.f;
 	}
 }
 
 void Brain::HandleFovEntities()
 {
-	m_pBlackboard->ChangeData(bb_IsInPurgeZone, false);
-	m_pBlackboard->ChangeData(bb_KnewEnemy, !m_Enemies.empty());
+	m_Board.Set<BrainSlot::IsInPurgeZone>(false);
+	m_Board.Set<BrainSlot::KnewEnemy>(!m_Enemies.empty());
 	m_Enemies.clear();
 
-	auto entities = GetEntitiesInFOV();
+	const auto entities = m_Perception.GetEntities();
 	for (size_t i = 0; i < entities.size(); i++)
 	{
 		switch (entities[i].Type)
@@ -544,7 +489,7 @@ void Brain::HandleFovEntities()
 
 void Brain::HandleItem(const EntityInfo& entity)
 {
-	auto agent = m_pInterface->Agent_GetInfo();
+	const auto& agent = m_Perception.GetAgent();
 	const float disSq = entity.Location.DistanceSquared(agent.Position);
 	if (disSq < powf(agent.GrabRange, 2.f))
 	{
@@ -552,64 +497,35 @@ void Brain::HandleItem(const EntityInfo& entity)
 		if (m_pInterface->Item_Grab(entity, item))
 		{
 			m_StuckProgress = 0.f;
+			// houses are stamped with the count after this frame's grabs
+			m_Perception.RefreshItemsPickedUp(m_pInterface);
 
-			int idx = -1;
-			std::vector<Vector2>* pVec = &m_KnownPistols;
 			switch (item.Type)
 			{
-			case eItemType::PISTOL: pVec = &m_KnownPistols; break;
-			case eItemType::MEDKIT: pVec = &m_KnownMedKits; break;
-			case eItemType::FOOD: pVec = &m_KnownFood; break;
-			case eItemType::GARBAGE: pVec = &m_KnownGarbage; break;
+			case eItemType::PISTOL:
+			case eItemType::MEDKIT:
+			case eItemType::FOOD:
+			case eItemType::GARBAGE:
+				break;
 			default:
 				std::cout << "UNKNOWN ITEM TYPE!" << std::endl;
 				return;
 			}
 
-			for (int i = 0; i < (int)pVec->size(); i++)
-			{
-				if (item.Location == pVec->at(i))
-				{
-					idx = i;
-					break;
-				}
-			}
-
-			if (idx == -1)
-			{
-				auto it = std::find(m_UnknownItems.cbegin(), m_UnknownItems.cend(), item.Location);
-				if (it != m_UnknownItems.cend())
-					m_UnknownItems.erase(it);
-			}
-
-			if (!m_pInventory->AddItem(item))
-			{
-				if (idx == -1)
-				{
-					pVec->push_back(item.Location);
-				}
-			}
+			// kept in the inventory it is gone from the map, else it stays known with its type
+			if (m_pInventory->AddItem(item))
+				m_Items.Remove(item.Location);
 			else
-			{
-				if (idx != -1)
-				{
-					pVec->at(idx) = pVec->back();
-					pVec->pop_back();
-				}
-			}
+				m_Items.Set(item.Location, item.Type);
 		}
 	}
 	else
 	{
-		if (std::find(m_KnownFood.cbegin(), m_KnownFood.cend(), entity.Location) != m_KnownFood.cend()
-			|| std::find(m_KnownGarbage.cbegin(), m_KnownGarbage.cend(), entity.Location) != m_KnownGarbage.cend()
-			|| std::find(m_KnownMedKits.cbegin(), m_KnownMedKits.cend(), entity.Location) != m_KnownMedKits.cend()
-			|| std::find(m_KnownPistols.cbegin(), m_KnownPistols.cend(), entity.Location) != m_KnownPistols.cend())
+		eItemType type;
+		if (m_Items.Find(entity.Location, type) && type != ItemKnowledge::Unknown)
 			return;
 
-		auto it = std::find(m_UnknownItems.cbegin(), m_UnknownItems.cend(), entity.Location);
-		if (it == m_UnknownItems.cend())
-			m_UnknownItems.push_back(entity.Location);
+		m_Items.Insert(entity.Location, ItemKnowledge::Unknown);
 
 		if (disSq < agent.Position.DistanceSquared(m_Target))
 			m_Target = entity.Location;
@@ -618,7 +534,7 @@ void Brain::HandleItem(const EntityInfo& entity)
 
 void Brain::HandleEnemy(const EntityInfo& entity)
 {
-	auto agent = m_pInterface->Agent_GetInfo();
+	const auto& agent = m_Perception.GetAgent();
 	EnemyInfoExtended info;
 	if (!m_pInterface->Enemy_GetInfo(entity, info))
 		return;
@@ -660,17 +576,18 @@ void Brain::HandlePurgeZone(const EntityInfo& entity)
 	if (!m_pInterface->PurgeZone_GetInfo(entity, pz))
 		return;
 
-	float distance = m_pInterface->Agent_GetInfo().Position.Distance(pz.Center);
-	if (distance < pz.Radius + m_pInterface->Agent_GetInfo().AgentSize + 1.f)
-		m_pBlackboard->ChangeData(bb_IsInPurgeZone, true);
+	const auto& agent = m_Perception.GetAgent();
+	float distance = agent.Position.Distance(pz.Center);
+	if (distance < pz.Radius + agent.AgentSize + 1.f)
+		m_Board.Set<BrainSlot::IsInPurgeZone>(true);
 
-	m_pBlackboard->ChangeData(bb_PurgeZoneInfo, pz);
-	m_pBlackboard->ChangeData(bb_PurgeZoneDistance, distance);
+	m_Board.Set<BrainSlot::PurgeZoneInfo>(pz);
+	m_Board.Set<BrainSlot::PurgeZoneDistance>(distance);
 }
 
 void Brain::UpdateEnemies(const float dt)
 {
-	const auto& agent = m_pInterface->Agent_GetInfo();
+	const auto& agent = m_Perception.GetAgent();
 	const float prolongedBittenTime = 4.f;
 	if (agent.Bitten)
 		m_BittenTime = 4.f;
@@ -679,11 +596,11 @@ void Brain::UpdateEnemies(const float dt)
 
 	if (m_Enemies.empty())
 	{
-		m_pBlackboard->ChangeData(bb_EnemyInSight, false);
-		m_pBlackboard->ChangeData(bb_EnemyInRange, false);
-		m_pBlackboard->ChangeData(bb_IsInCombat, m_BittenTime > 0.f);
-		m_pBlackboard->ChangeData(bb_NearestEnemy, agent.Position - RotateVector(m_Forward, F_PI / 2.f));
-		m_pBlackboard->ChangeData(bb_EnemyCenter,
+		m_Board.Set<BrainSlot::EnemyInSight>(false);
+		m_Board.Set<BrainSlot::EnemyInRange>(false);
+		m_Board.Set<BrainSlot::IsInCombat>(m_BittenTime > 0.f);
+		m_Board.Set<BrainSlot::NearestEnemy>(agent.Position - RotateVector(m_Forward, F_PI / 2.f));
+		m_Board.Set<BrainSlot::EnemyCenter>(
 			agent.Position - RotateVector(m_Forward, -(m_BittenTime / prolongedBittenTime) * F_PI * 2.f));
 		return;
 	}
@@ -747,53 +664,18 @@ void Brain::UpdateEnemies(const float dt)
 		nearestEnemy = m_Enemies[nearestIdx].Location;
 
 	center /= float(m_Enemies.size());
-	m_pBlackboard->ChangeData(bb_EnemyInSight, true);
-	m_pBlackboard->ChangeData(bb_EnemyInRange, grabRangeIdx != -1);
-	m_pBlackboard->ChangeData(bb_IsInCombat, grabRangeIdx != -1 || m_Enemies.size() > 3 || m_BittenTime > 0.f);
-	m_pBlackboard->ChangeData(bb_NearestEnemy, nearestEnemy);
-	m_pBlackboard->ChangeData(bb_EnemyCenter, center);
+	m_Board.Set<BrainSlot::EnemyInSight>(true);
+	m_Board.Set<BrainSlot::EnemyInRange>(grabRangeIdx != -1);
+	m_Board.Set<BrainSlot::IsInCombat>(grabRangeIdx != -1 || m_Enemies.size() > 3 || m_BittenTime > 0.f);
+	m_Board.Set<BrainSlot::NearestEnemy>(nearestEnemy);
+	m_Board.Set<BrainSlot::EnemyCenter>(center);
 }
 
 bool Brain::GetNearestUnknownItem(Elite::Vector2& target) const
 {
-	auto agentPos = m_pInterface->Agent_GetInfo().Position;
-	float shortestSq = FLT_MAX;
-	int idx = -1;
-	for (int i = 0; i < (int)m_UnknownItems.size(); i++)
-	{
-		float distanceSq = (m_UnknownItems[i] - agentPos).SqrtMagnitude();
-		if (distanceSq < shortestSq)
-		{
-			shortestSq = distanceSq;
-			idx = i;
-		}
-	}
-
-	if (idx == -1)
-		return false;
-
-	target = m_UnknownItems[idx];
-	return true;
+	return m_Items.GetNearest(m_Perception.GetAgent().Position, ItemKnowledge::Unknown, target);
 }
 
-vector<EntityInfo> Brain::GetEntitiesInFOV() const
-{
-	vector<EntityInfo> vEntitiesInFOV = {};
-
-	EntityInfo ei = {};
-	for (int i = 0;; ++i)
-	{
-		if (m_pInterface->Fov_GetEntityByIndex(i, ei))
-		{
-			vEntitiesInFOV.push_back(ei);
-			continue;
-		}
-
-		break;
-	}
-
-	return vEntitiesInFOV;
-}
 #pragma endregion
 
 #pragma region BLACKBOARD ----------------------------------------------------------------------------
@@ -802,39 +684,39 @@ void Brain::InitializeBlackboard()
 	m_pBlackboard = new Blackboard{};
 	m_pBlackboard->AddData(bb_pInterface, m_pInterface);
 
-	m_pBlackboard->AddData(bb_HasLowHealth, false);
-	m_pBlackboard->AddData(bb_HasLowEnergy, false);
-	m_pBlackboard->AddData(bb_HasPistol, false);
-	m_pBlackboard->AddData(bb_HasFreeSlot, false);
-
-	m_pBlackboard->AddData(bb_IsInPurgeZone, false);
-	m_pBlackboard->AddData(bb_PurgeZoneInfo, PurgeZoneInfo{});
-	m_pBlackboard->AddData(bb_PurgeZoneDistance, 0.f);
-
-	m_pBlackboard->AddData(bb_HasUnknownItem, false);
-	m_pBlackboard->AddData(bb_UnknownItemInArea, false);
-	m_pBlackboard->AddData(bb_KnowsMedKit, false);
-	m_pBlackboard->AddData(bb_KnowsPistol, false);
-	m_pBlackboard->AddData(bb_KnowsFood, false);
-	m_pBlackboard->AddData(bb_KnowsGarbage, false);
-
-	m_pBlackboard->AddData(bb_KnowsHouse, false);
-	m_pBlackboard->AddData(bb_IsInHouse, false);
-	m_pBlackboard->AddData(bb_HouseIsExplored, false);
-	m_pBlackboard->AddData(bb_NextHouseIsExplored, false);
-	m_pBlackboard->AddData(bb_NearestUnexploredCorner, ZeroVector2);
-	m_pBlackboard->AddData(bb_ExplorationTarget, ZeroVector2);
-	m_pBlackboard->AddData(bb_HouseCloserThanExploration, false);
-
-	m_pBlackboard->AddData(bb_IsStuck, false);
-	m_pBlackboard->AddData(bb_StuckTarget, ZeroVector2);
-
-	m_pBlackboard->AddData(bb_IsInCombat, false);
-	m_pBlackboard->AddData(bb_EnemyInSight, false);
-	m_pBlackboard->AddData(bb_EnemyInRange, false);
-	m_pBlackboard->AddData(bb_KnewEnemy, false);
-
-	m_pBlackboard->AddData(bb_HasFullStamina, true);
+	m_Board.Bind<BrainSlot::HasLowHealth>(bb_HasLowHealth, false);
+	m_Board.Bind<BrainSlot::HasLowEnergy>(bb_HasLowEnergy, false);
+	m_Board.Bind<BrainSlot::HasPistol>(bb_HasPistol, false);
+	m_Board.Bind<BrainSlot::HasFreeSlot>(bb_HasFreeSlot, false);
+
+	m_Board.Bind<BrainSlot::IsInPurgeZone>(bb_IsInPurgeZone, false);
+	m_Board.Bind<BrainSlot::PurgeZoneInfo>(bb_PurgeZoneInfo, PurgeZoneInfo{});
+	m_Board.Bind<BrainSlot::PurgeZoneDistance>(bb_PurgeZoneDistance, 0.f);
+
+	m_Board.Bind<BrainSlot::HasUnknownItem>(bb_HasUnknownItem, false);
+	m_Board.Bind<BrainSlot::UnknownItemInArea>(bb_UnknownItemInArea, false);
+	m_Board.Bind<BrainSlot::KnowsMedKit>(bb_KnowsMedKit, false);
+	m_Board.Bind<BrainSlot::KnowsPistol>(bb_KnowsPistol, false);
+	m_Board.Bind<BrainSlot::KnowsFood>(bb_KnowsFood, false);
+	m_Board.Bind<BrainSlot::KnowsGarbage>(bb_KnowsGarbage, false);
+
+	m_Board.Bind<BrainSlot::KnowsHouse>(bb_KnowsHouse, false);
+	m_Board.Bind<BrainSlot::IsInHouse>(bb_IsInHouse, false);
+	m_Board.Bind<BrainSlot::HouseIsExplored>(bb_HouseIsExplored, false);
+	m_Board.Bind<BrainSlot::NextHouseIsExplored>(bb_NextHouseIsExplored, false);
+	m_Board.Bind<BrainSlot::NearestUnexploredCorner>(bb_NearestUnexploredCorner, ZeroVector2);
+	m_Board.Bind<BrainSlot::ExplorationTarget>(bb_ExplorationTarget, ZeroVector2);
+	m_Board.Bind<BrainSlot::HouseCloserThanExploration>(bb_HouseCloserThanExploration, false);
+
+	m_Board.Bind<BrainSlot::IsStuck>(bb_IsStuck, false);
+	m_Board.Bind<BrainSlot::StuckTarget>(bb_StuckTarget, ZeroVector2);
+
+	m_Board.Bind<BrainSlot::IsInCombat>(bb_IsInCombat, false);
+	m_Board.Bind<BrainSlot::EnemyInSight>(bb_EnemyInSight, false);
+	m_Board.Bind<BrainSlot::EnemyInRange>(bb_EnemyInRange, false);
+	m_Board.Bind<BrainSlot::KnewEnemy>(bb_KnewEnemy, false);
+
+	m_Board.Bind<BrainSlot::HasFullStamina>(bb_HasFullStamina, true);
 	m_pBlackboard->AddData(bb_pRunMode, &m_RunMode);
 	m_pBlackboard->AddData(bb_ShouldRun, false);
 
@@ -851,33 +733,34 @@ void Brain::InitializeBlackboard()
 	m_pBlackboard->AddData(bb_OrientationTarget, ZeroVector2);
 
 	// targets
-	m_pBlackboard->AddData(bb_HouseLocation, ZeroVector2);
-	m_pBlackboard->AddData(bb_NearestItem, eItemType::RANDOM_DROP);
-	m_pBlackboard->AddData(bb_NearestUnknownItem, ZeroVector2);
-	m_pBlackboard->AddData(bb_NearestMedKit, ZeroVector2);
-	m_pBlackboard->AddData(bb_NearestPistol, ZeroVector2);
-	m_pBlackboard->AddData(bb_NearestFood, ZeroVector2);
-	m_pBlackboard->AddData(bb_NearestGarbage, ZeroVector2);
-	m_pBlackboard->AddData(bb_NearestEnemy, ZeroVector2);
-	m_pBlackboard->AddData(bb_EnemyCenter, ZeroVector2);
+	m_Board.Bind<BrainSlot::HouseLocation>(bb_HouseLocation, ZeroVector2);
+	m_Board.Bind<BrainSlot::NearestItem>(bb_NearestItem, eItemType::RANDOM_DROP);
+	m_Board.Bind<BrainSlot::NearestUnknownItem>(bb_NearestUnknownItem, ZeroVector2);
+	m_Board.Bind<BrainSlot::NearestMedKit>(bb_NearestMedKit, ZeroVector2);
+	m_Board.Bind<BrainSlot::NearestPistol>(bb_NearestPistol, ZeroVector2);
+	m_Board.Bind<BrainSlot::NearestFood>(bb_NearestFood, ZeroVector2);
+	m_Board.Bind<BrainSlot::NearestGarbage>(bb_NearestGarbage, ZeroVector2);
+	m_Board.Bind<BrainSlot::NearestEnemy>(bb_NearestEnemy, ZeroVector2);
+	m_Board.Bind<BrainSlot::EnemyCenter>(bb_EnemyCenter, ZeroVector2);
+	m_Board.AddTo(*m_pBlackboard);
 }
 
 void Brain::UpdateBlackboard()
 {
-	const auto& agent = m_pInterface->Agent_GetInfo();
+	const auto& agent = m_Perception.GetAgent();
 
-	m_pBlackboard->ChangeData(bb_HasLowHealth, agent.Health < 7.f);
-	m_pBlackboard->ChangeData(bb_HasLowEnergy, agent.Energy < 1.f);
+	m_Board.Set<BrainSlot::HasLowHealth>(agent.Health < 7.f);
+	m_Board.Set<BrainSlot::HasLowEnergy>(agent.Energy < 1.f);
 
 	if (m_HasFullStamina)
 		m_HasFullStamina = agent.Stamina > 9.f;
 	else
 		m_HasFullStamina = agent.Stamina > 9.9f;
 
-	m_pBlackboard->ChangeData(bb_HasFullStamina, m_HasFullStamina);
+	m_Board.Set<BrainSlot::HasFullStamina>(m_HasFullStamina);
 
-	m_pBlackboard->ChangeData(bb_HasPistol, m_pInventory->HasItemOfType(eItemType::PISTOL));
-	m_pBlackboard->ChangeData(bb_HasFreeSlot, m_pInventory->HasItemOfType(eItemType::RANDOM_DROP));
+	m_Board.Set<BrainSlot::HasPistol>(m_pInventory->HasItemOfType(eItemType::PISTOL));
+	m_Board.Set<BrainSlot::HasFreeSlot>(m_pInventory->HasItemOfType(eItemType::RANDOM_DROP));
 }
 
 void Brain::CleanBlackboard()
@@ -902,167 +785,49 @@ void Brain::CleanBlackboard()
 void Brain::InitializeBehaviorTree()
 {
 	InitializeBlackboard();
-	m_pBehaviorTree = new BehaviorTree{ m_pBlackboard, new BehaviorSequence
-	{{
-		new BehaviorSelector // movement --------------------------------------------
-		{{
-			new BehaviorSequence // purge zone
-			{{
-				new BehaviorConditional{IsInPurgeZone},
-				new BehaviorAction{SetRunMode},
-				new BehaviorAction{SetTargetPurgeZoneEscape},
-				new BehaviorAction{SetSeek}
-			}},
-
-			new BehaviorSequence // combat
-			{{
-				new BehaviorSelector
-				{{
-					new BehaviorConditional{IsInCombat},
-					new BehaviorConditional{EnemyInRange},
-				}},
-
-				new BehaviorSelector
-				{{
-					new BehaviorSequence
-					{{
-						new BehaviorConditional{HasPistol},
-						new BehaviorSelector
-						{{
-							new BehaviorConditional{KnewEnemy},
-							new BehaviorAction{InitializeFlee},
-						}},
-						new BehaviorAction{SetMovementEnemyCenter},
-						new BehaviorAction{SetFlee},
-					}},
-
-					new BehaviorSequence
-					{{
-						new BehaviorAction{SetRunMode},
-						new BehaviorConditional{FalseCondition},
-					}},
-				}},
-			}},
-
-			new BehaviorSequence // unknown item in sight
-			{{
-				new BehaviorConditional{UnknownItemInSight},
-				new BehaviorAction{SetMovementUnknownItem},
-				new BehaviorAction{SetSeek}
-			}},
-
-			new BehaviorSequence // unstuck
-			{{
-				new BehaviorConditional{IsStuck},
-				new BehaviorAction{SetRunMode},
-				new BehaviorAction{SetMovementExplore},
-				new BehaviorAction{SetSeek}
-			}},
-
-			new BehaviorSequence // healing
-			{{
-				new BehaviorConditional{HasLowHealth},
-				new BehaviorConditional{KnowsMedKit},
-				new BehaviorAction{SetMovementMedKit},
-				new BehaviorConditional{TargetCloserThanHouse},
-				new BehaviorAction{SetSeek},
-			}},
-
-			new BehaviorSequence // food
-			{{
-				new BehaviorConditional{HasNotLowHealth},
-				new BehaviorConditional{HasLowEnergy},
-				new BehaviorConditional{KnowsFood},
-				new BehaviorAction{SetMovementFood},
-				new BehaviorConditional{TargetCloserThanHouse},
-				new BehaviorAction{SetSeek}
-			}},
-
-			new BehaviorSequence // pistol
-			{{
-				new BehaviorConditional{HasNotLowHealth},
-				new BehaviorConditional{HasNotLowEnergy},
-				new BehaviorConditional{HasNoPistol},
-				new BehaviorConditional{KnowsPistol},
-				new BehaviorAction{SetMovementPistol},
-				new BehaviorConditional{TargetCloserThanHouse},
-				new BehaviorAction{SetSeek}
-			}},
-
-			new BehaviorSequence // explore house
-			{{
-				new BehaviorConditional{IsInHouse},
-				new BehaviorConditional{HouseIsNotExplored},
-				new BehaviorAction{SetMovementNearestUnexploredCorner},
-				new BehaviorAction{SetSeek}
-			}},
-
-			new BehaviorSequence // move to next unknown item
-			{{
-				new BehaviorConditional{HasUnknownItem},
-				new BehaviorAction{SetMovementUnknownItem},
-				new BehaviorConditional{TargetCloserThanHouse},
-				new BehaviorAction{SetSeek}
-			}},
-
-		new BehaviorSequence // move to next known item
-		{{
-			new BehaviorConditional{HasFreeInventorySlot},
-			new BehaviorConditional{HasNotLowHealth},
-			new BehaviorConditional{HasNotLowEnergy},
-			new BehaviorConditional{HasPistol},
-			new BehaviorAction{SetMovementItem},
-			new BehaviorConditional{TargetCloserThanHouse},
-			new BehaviorAction{SetSeek}
-		}},
-
-		new BehaviorSequence // move to next house
-		{{
-			new BehaviorConditional{KnowsHouse},
-			new BehaviorAction{SetMovementHouse},
-			new BehaviorAction{SetSeek}
-		}},
-
-		new BehaviorSequence // towards random location
-		{{
-			new BehaviorAction{SetMovementExplore},
-			new BehaviorAction{SetSeek}
-		}},
-	}},
-
-	new BehaviorSelector // orientation -----------------------------------------------
-	{{
-		new BehaviorSequence // combat
-		{{
-			new BehaviorSelector
-			{{
-				new BehaviorConditional{IsInCombat},
-				new BehaviorConditional{EnemyInSight},
-			}},
-			new BehaviorConditional{HasPistol},
-			new BehaviorAction{SetOrientationNearestEnemy},
-			new BehaviorAction{SetRotateIntoFront},
-		}},
-
-		new BehaviorSequence // unknown item in sight
-		{{
-			new BehaviorConditional{UnknownItemInSight},
-			new BehaviorAction{SetForwardScanning},
-		}},
-
-		new BehaviorSequence // stuck
-		{{
-			new BehaviorConditional{IsStuck},
-			new BehaviorAction{SetFullScanning},
-		}},
-
-		new BehaviorAction{SetForwardScanning},
-	}},
-
-	new BehaviorSequence // extra run mode
-	{{
-		new BehaviorConditional{HasFullStamina},
-		new BehaviorAction{SetRunMode},
-	}},
-}} };
+	using Tree = FlatBehaviorTree;
+	BrainTreeLeaves leaves;
+	leaves.isInPurgeZone = Tree::Flag(&m_Board.Get<BrainSlot::IsInPurgeZone>());
+	leaves.isInCombat = Tree::Flag(&m_Board.Get<BrainSlot::IsInCombat>());
+	leaves.enemyInRange = Tree::Flag(&m_Board.Get<BrainSlot::EnemyInRange>());
+	leaves.hasPistol = Tree::Flag(&m_Board.Get<BrainSlot::HasPistol>());
+	leaves.knewEnemy = Tree::Flag(&m_Board.Get<BrainSlot::KnewEnemy>());
+	leaves.falseCondition = Tree::Conditional(FalseCondition);
+	leaves.unknownItemInSight = Tree::Conditional(UnknownItemInSight);
+	leaves.isStuck = Tree::Flag(&m_Board.Get<BrainSlot::IsStuck>());
+	leaves.hasLowHealth = Tree::Flag(&m_Board.Get<BrainSlot::HasLowHealth>());
+	leaves.knowsMedKit = Tree::Flag(&m_Board.Get<BrainSlot::KnowsMedKit>());
+	leaves.targetCloserThanHouse = Tree::Conditional(TargetCloserThanHouse);
+	leaves.hasNotLowHealth = Tree::Flag(&m_Board.Get<BrainSlot::HasLowHealth>(), false);
+	leaves.hasLowEnergy = Tree::Flag(&m_Board.Get<BrainSlot::HasLowEnergy>());
+	leaves.knowsFood = Tree::Flag(&m_Board.Get<BrainSlot::KnowsFood>());
+	leaves.hasNotLowEnergy = Tree::Flag(&m_Board.Get<BrainSlot::HasLowEnergy>(), false);
+	leaves.hasNoPistol = Tree::Flag(&m_Board.Get<BrainSlot::HasPistol>(), false);
+	leaves.knowsPistol = Tree::Flag(&m_Board.Get<BrainSlot::KnowsPistol>());
+	leaves.isInHouse = Tree::Flag(&m_Board.Get<BrainSlot::IsInHouse>());
+	leaves.houseIsNotExplored = Tree::Flag(&m_Board.Get<BrainSlot::HouseIsExplored>(), false);
+	leaves.hasUnknownItem = Tree::Flag(&m_Board.Get<BrainSlot::HasUnknownItem>());
+	leaves.hasFreeInventorySlot = Tree::Conditional(HasFreeInventorySlot);
+	leaves.knowsHouse = Tree::Flag(&m_Board.Get<BrainSlot::KnowsHouse>());
+	leaves.enemyInSight = Tree::Flag(&m_Board.Get<BrainSlot::EnemyInSight>());
+	leaves.hasFullStamina = Tree::Flag(&m_Board.Get<BrainSlot::HasFullStamina>());
+	leaves.setRunMode = Tree::Action(SetRunMode);
+	leaves.setTargetPurgeZoneEscape = Tree::Action(SetTargetPurgeZoneEscape);
+	leaves.setSeek = Tree::Action(SetSeek);
+	leaves.initializeFlee = Tree::Action(InitializeFlee);
+	leaves.setMovementEnemyCenter = Tree::Action(SetMovementEnemyCenter);
+	leaves.setFlee = Tree::Action(SetFlee);
+	leaves.setMovementUnknownItem = Tree::Action(SetMovementUnknownItem);
+	leaves.setMovementExplore = Tree::Action(SetMovementExplore);
+	leaves.setMovementMedKit = Tree::Action(SetMovementMedKit);
+	leaves.setMovementFood = Tree::Action(SetMovementFood);
+	leaves.setMovementPistol = Tree::Action(SetMovementPistol);
+	leaves.setMovementNearestUnexploredCorner = Tree::Action(SetMovementNearestUnexploredCorner);
+	leaves.setMovementItem = Tree::Action(SetMovementItem);
+	leaves.setMovementHouse = Tree::Action(SetMovementHouse);
+	leaves.setOrientationNearestEnemy = Tree::Action(SetOrientationNearestEnemy);
+	leaves.setRotateIntoFront = Tree::Action(SetRotateIntoFront);
+	leaves.setForwardScanning = Tree::Action(SetForwardScanning);
+	leaves.setFullScanning = Tree::Action(SetFullScanning);
+	m_pBehaviorTree = new FlatBehaviorTree{ m_pBlackboard, BrainTreeShape(leaves) };
 }
\ No newline at end of file
@@ -3,22 +3,19 @@
 #include "IExamPlugin.h"
 #include "Exam_HelperStructs.h"
 #include "SteeringBehaviors.h"
+#include "ItemKnowledge.h"
+#include "HouseIndex.h"
+#include "Perception.h"
+#include "BrainBlackboard.h"
 
 class IExamInterface;
 class InventoryManager;
+class FlatBehaviorTree;
 namespace Elite
 {
 	class Blackboard;
-	class BehaviorTree;
 }
 
-struct HouseInfoExtended : HouseInfo
-{
-	int ItemsPickedUp;
-	Elite::Vector2 Corners[4];
-	bool CornersSeen[4];
-};
-
 struct EnemyInfoExtended : EnemyInfo
 {
 	bool InSight;
@@ -55,12 +52,9 @@ private:
 	bool m_IsInitialized;
 	IExamInterface* m_pInterface;
 	InventoryManager* m_pInventory;
-	std::vector<Elite::Vector2> m_KnownGarbage;
-	std::vector<Elite::Vector2> m_KnownPistols;
-	std::vector<Elite::Vector2> m_KnownMedKits;
-	std::vector<Elite::Vector2> m_KnownFood;
-	std::vector<Elite::Vector2> m_UnknownItems;
-	std::vector<HouseInfoExtended> m_Houses;
+	Perception m_Perception;
+	ItemKnowledge m_Items;
+	HouseIndex m_Houses;
 	int m_CurrentHouseIdx;
 	bool m_WasInHouse;
 	bool m_RunMode;
@@ -89,7 +83,10 @@ private:
 	RotateIntoVision* m_pRotateIntoVision;
 
 	Elite::Blackboard* m_pBlackboard;
-	Elite::BehaviorTree* m_pBehaviorTree;
+	// written by the brain, published to m_pBlackboard once per frame before the tree runs,
+	// the flag leaves of the tree read it directly
+	BrainBlackboard m_Board;
+	FlatBehaviorTree* m_pBehaviorTree;
 
 
 	void HandleStuck(const float dt);
@@ -114,9 +111,6 @@ private:
 
 	bool GetNearestUnknownItem(Elite::Vector2& target) const;
 
-	vector<HouseInfo> GetHousesInFOV() const;
-	vector<EntityInfo> GetEntitiesInFOV() const;
-
 	void InitializeBehaviorTree();
 	void InitializeBlackboard();
 	void CleanBlackboard();
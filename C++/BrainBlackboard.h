@@ -0,0 +1,97 @@
+#pragma once
+#include "stdafx.h"
+#include "Exam_HelperStructs.h"
+#include "TypedBlackboard.h"
+
+// The entries Brain writes every frame, one slot each. Conditionals that only test one of the
+// bools are flag leaves of the tree, reading the slot in place. The behaviors read the rest
+// from the Elite::Blackboard under the bb_* keys they are bound to in Brain::InitializeBlackboard.
+// Pointers and the entries only the behaviors write stay in the Elite::Blackboard alone. A slot
+// is only published when it changes, so a behavior writing a bound key would win over the brain
+// from then on; Brain::Update asserts in debug builds that none does.
+// PurgeZoneInfo has no operator==, it is published whenever it is set.
+namespace BrainSlot
+{
+	using HasLowHealth = BlackboardSlot<bool, 0>;
+	using HasLowEnergy = BlackboardSlot<bool, 1>;
+	using HasPistol = BlackboardSlot<bool, 2>;
+	using HasFreeSlot = BlackboardSlot<bool, 3>;
+
+	using IsInPurgeZone = BlackboardSlot<bool, 4>;
+	using PurgeZoneInfo = BlackboardSlot<::PurgeZoneInfo, 5>;
+	using PurgeZoneDistance = BlackboardSlot<float, 6>;
+
+	using HasUnknownItem = BlackboardSlot<bool, 7>;
+	using UnknownItemInArea = BlackboardSlot<bool, 8>;
+	using KnowsMedKit = BlackboardSlot<bool, 9>;
+	using KnowsPistol = BlackboardSlot<bool, 10>;
+	using KnowsFood = BlackboardSlot<bool, 11>;
+	using KnowsGarbage = BlackboardSlot<bool, 12>;
+
+	using KnowsHouse = BlackboardSlot<bool, 13>;
+	using IsInHouse = BlackboardSlot<bool, 14>;
+	using HouseIsExplored = BlackboardSlot<bool, 15>;
+	using NextHouseIsExplored = BlackboardSlot<bool, 16>;
+	using NearestUnexploredCorner = BlackboardSlot<Elite::Vector2, 17>;
+	using ExplorationTarget = BlackboardSlot<Elite::Vector2, 18>;
+	using HouseCloserThanExploration = BlackboardSlot<bool, 19>;
+
+	using IsStuck = BlackboardSlot<bool, 20>;
+	using StuckTarget = BlackboardSlot<Elite::Vector2, 21>;
+
+	using IsInCombat = BlackboardSlot<bool, 22>;
+	using EnemyInSight = BlackboardSlot<bool, 23>;
+	using EnemyInRange = BlackboardSlot<bool, 24>;
+	using KnewEnemy = BlackboardSlot<bool, 25>;
+
+	using HasFullStamina = BlackboardSlot<bool, 26>;
+
+	// targets
+	using HouseLocation = BlackboardSlot<Elite::Vector2, 27>;
+	using NearestItem = BlackboardSlot<eItemType, 28>;
+	using NearestUnknownItem = BlackboardSlot<Elite::Vector2, 29>;
+	using NearestMedKit = BlackboardSlot<Elite::Vector2, 30>;
+	using NearestPistol = BlackboardSlot<Elite::Vector2, 31>;
+	using NearestFood = BlackboardSlot<Elite::Vector2, 32>;
+	using NearestGarbage = BlackboardSlot<Elite::Vector2, 33>;
+	using NearestEnemy = BlackboardSlot<Elite::Vector2, 34>;
+	using EnemyCenter = BlackboardSlot<Elite::Vector2, 35>;
+}
+
+using BrainBlackboard = TypedBlackboard<
+	BrainSlot::HasLowHealth,
+	BrainSlot::HasLowEnergy,
+	BrainSlot::HasPistol,
+	BrainSlot::HasFreeSlot,
+	BrainSlot::IsInPurgeZone,
+	BrainSlot::PurgeZoneInfo,
+	BrainSlot::PurgeZoneDistance,
+	BrainSlot::HasUnknownItem,
+	BrainSlot::UnknownItemInArea,
+	BrainSlot::KnowsMedKit,
+	BrainSlot::KnowsPistol,
+	BrainSlot::KnowsFood,
+	BrainSlot::KnowsGarbage,
+	BrainSlot::KnowsHouse,
+	BrainSlot::IsInHouse,
+	BrainSlot::HouseIsExplored,
+	BrainSlot::NextHouseIsExplored,
+	BrainSlot::NearestUnexploredCorner,
+	BrainSlot::ExplorationTarget,
+	BrainSlot::HouseCloserThanExploration,
+	BrainSlot::IsStuck,
+	BrainSlot::StuckTarget,
+	BrainSlot::IsInCombat,
+	BrainSlot::EnemyInSight,
+	BrainSlot::EnemyInRange,
+	BrainSlot::KnewEnemy,
+	BrainSlot::HasFullStamina,
+	BrainSlot::HouseLocation,
+	BrainSlot::NearestItem,
+	BrainSlot::NearestUnknownItem,
+	BrainSlot::NearestMedKit,
+	BrainSlot::NearestPistol,
+	BrainSlot::NearestFood,
+	BrainSlot::NearestGarbage,
+	BrainSlot::NearestEnemy,
+	BrainSlot::EnemyCenter>;
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include "BrainTreeShape.h"
+
+FlatBehaviorTree::Desc BrainTreeShape(const BrainTreeLeaves& b)
+{
+	using Tree = FlatBehaviorTree;
+	return Tree::Sequence
+	({
+		Tree::Selector // movement --------------------------------------------
+		({
+			Tree::Sequence // purge zone
+			({
+				b.isInPurgeZone,
+				b.setRunMode,
+				b.setTargetPurgeZoneEscape,
+				b.setSeek
+			}),
+
+			Tree::Sequence // combat
+			({
+				Tree::Selector
+				({
+					b.isInCombat,
+					b.enemyInRange,
+				}),
+
+				Tree::Selector
+				({
+					Tree::Sequence
+					({
+						b.hasPistol,
+						Tree::Selector
+						({
+							b.knewEnemy,
+							b.initializeFlee,
+						}),
+						b.setMovementEnemyCenter,
+						b.setFlee,
+					}),
+
+					Tree::Sequence
+					({
+						b.setRunMode,
+						b.falseCondition,
+					}),
+				}),
+			}),
+
+			Tree::Sequence // unknown item in sight
+			({
+				b.unknownItemInSight,
+				b.setMovementUnknownItem,
+				b.setSeek
+			}),
+
+			Tree::Sequence // unstuck
+			({
+				b.isStuck,
+				b.setRunMode,
+				b.setMovementExplore,
+				b.setSeek
+			}),
+
+			Tree::Sequence // healing
+			({
+				b.hasLowHealth,
+				b.knowsMedKit,
+				b.setMovementMedKit,
+				b.targetCloserThanHouse,
+				b.setSeek,
+			}),
+
+			Tree::Sequence // food
+			({
+				b.hasNotLowHealth,
+				b.hasLowEnergy,
+				b.knowsFood,
+				b.setMovementFood,
+				b.targetCloserThanHouse,
+				b.setSeek
+			}),
+
+			Tree::Sequence // pistol
+			({
+				b.hasNotLowHealth,
+				b.hasNotLowEnergy,
+				b.hasNoPistol,
+				b.knowsPistol,
+				b.setMovementPistol,
+				b.targetCloserThanHouse,
+				b.setSeek
+			}),
+
+			Tree::Sequence // explore house
+			({
+				b.isInHouse,
+				b.houseIsNotExplored,
+				b.setMovementNearestUnexploredCorner,
+				b.setSeek
+			}),
+
+			Tree::Sequence // move to next unknown item
+			({
+				b.hasUnknownItem,
+				b.setMovementUnknownItem,
+				b.targetCloserThanHouse,
+				b.setSeek
+			}),
+
+		Tree::Sequence // move to next known item
+		({
+			b.hasFreeInventorySlot,
+			b.hasNotLowHealth,
+			b.hasNotLowEnergy,
+			b.hasPistol,
+			b.setMovementItem,
+			b.targetCloserThanHouse,
+			b.setSeek
+		}),
+
+		Tree::Sequence // move to next house
+		({
+			b.knowsHouse,
+			b.setMovementHouse,
+			b.setSeek
+		}),
+
+		Tree::Sequence // towards random location
+		({
+			b.setMovementExplore,
+			b.setSeek
+		}),
+	}),
+
+	Tree::Selector // orientation -----------------------------------------------
+	({
+		Tree::Sequence // combat
+		({
+			Tree::Selector
+			({
+				b.isInCombat,
+				b.enemyInSight,
+			}),
+			b.hasPistol,
+			b.setOrientationNearestEnemy,
+			b.setRotateIntoFront,
+		}),
+
+		Tree::Sequence // unknown item in sight
+		({
+			b.unknownItemInSight,
+			b.setForwardScanning,
+		}),
+
+		Tree::Sequence // stuck
+		({
+			b.isStuck,
+			b.setFullScanning,
+		}),
+
+		b.setForwardScanning,
+	}),
+
+	Tree::Sequence // extra run mode
+	({
+		b.hasFullStamina,
+		b.setRunMode,
+	}),
+});
+}
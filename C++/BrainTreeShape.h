@@ -0,0 +1,56 @@
+#pragma once
+#include "FlatBehaviorTree.h"
+
+// the leaves of the brain's behavior tree, one per condition and action it uses
+struct BrainTreeLeaves
+{
+	// conditions
+	FlatBehaviorTree::Desc isInPurgeZone;
+	FlatBehaviorTree::Desc isInCombat;
+	FlatBehaviorTree::Desc enemyInRange;
+	FlatBehaviorTree::Desc hasPistol;
+	FlatBehaviorTree::Desc knewEnemy;
+	FlatBehaviorTree::Desc falseCondition;
+	FlatBehaviorTree::Desc unknownItemInSight;
+	FlatBehaviorTree::Desc isStuck;
+	FlatBehaviorTree::Desc hasLowHealth;
+	FlatBehaviorTree::Desc knowsMedKit;
+	FlatBehaviorTree::Desc targetCloserThanHouse;
+	FlatBehaviorTree::Desc hasNotLowHealth;
+	FlatBehaviorTree::Desc hasLowEnergy;
+	FlatBehaviorTree::Desc knowsFood;
+	FlatBehaviorTree::Desc hasNotLowEnergy;
+	FlatBehaviorTree::Desc hasNoPistol;
+	FlatBehaviorTree::Desc knowsPistol;
+	FlatBehaviorTree::Desc isInHouse;
+	FlatBehaviorTree::Desc houseIsNotExplored;
+	FlatBehaviorTree::Desc hasUnknownItem;
+	FlatBehaviorTree::Desc hasFreeInventorySlot;
+	FlatBehaviorTree::Desc knowsHouse;
+	FlatBehaviorTree::Desc enemyInSight;
+	FlatBehaviorTree::Desc hasFullStamina;
+
+	// actions
+	FlatBehaviorTree::Desc setRunMode;
+	FlatBehaviorTree::Desc setTargetPurgeZoneEscape;
+	FlatBehaviorTree::Desc setSeek;
+	FlatBehaviorTree::Desc initializeFlee;
+	FlatBehaviorTree::Desc setMovementEnemyCenter;
+	FlatBehaviorTree::Desc setFlee;
+	FlatBehaviorTree::Desc setMovementUnknownItem;
+	FlatBehaviorTree::Desc setMovementExplore;
+	FlatBehaviorTree::Desc setMovementMedKit;
+	FlatBehaviorTree::Desc setMovementFood;
+	FlatBehaviorTree::Desc setMovementPistol;
+	FlatBehaviorTree::Desc setMovementNearestUnexploredCorner;
+	FlatBehaviorTree::Desc setMovementItem;
+	FlatBehaviorTree::Desc setMovementHouse;
+	FlatBehaviorTree::Desc setOrientationNearestEnemy;
+	FlatBehaviorTree::Desc setRotateIntoFront;
+	FlatBehaviorTree::Desc setForwardScanning;
+	FlatBehaviorTree::Desc setFullScanning;
+};
+
+// The shape of the brain's behavior tree: movement, then orientation, then the extra run mode.
+// Brain fills in its leaves, the behavior tree benchmark stand-ins, so both tick the same tree.
+FlatBehaviorTree::Desc BrainTreeShape(const BrainTreeLeaves& b);
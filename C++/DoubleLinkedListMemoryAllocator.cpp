@@ -1,102 +1,384 @@
 #include "DoubleLinkedListMemoryAllocator.h"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
 
-DoubleLinkedListMemoryAllocator::DoubleLinkedListMemoryAllocator(size_t nbBytes)
-	: m_BlockAmount{ size_t((nbBytes + 2 * sizeof(DoubleLinkBlock) - 1) / sizeof(DoubleLinkBlock)) }
-#ifdef _DEBUG
-	, m_UsedBlocks{ 0 }
-#endif
+template<size_t BlockSize, typename THeader>
+BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::BasicDoubleLinkedListMemoryAllocator(size_t nbBytes, eCoalescing coalescing, ePlacement placement, eBackingStore store)
+	: m_BlockAmount{ size_t((nbBytes + 2 * sizeof(Block) - 1) / sizeof(Block)) }
+	, m_Placement{ placement }
+	, m_Coalescing{ placement == ePlacement::BestFit ? eCoalescing::Eager : coalescing }
+	, m_pTreeRoot{ nullptr }
+	, m_Store{ store }
+	, m_DiscardBytes{ size_t(256) << 10 }
+	, m_Stats{}
 {
-#ifdef _DEBUG
-	m_pHead = reinterpret_cast<DoubleLinkBlock*>(calloc(m_BlockAmount, sizeof(DoubleLinkBlock)));
-#else
-	m_pHead = reinterpret_cast<DoubleLinkBlock*>(malloc(m_BlockAmount * sizeof(DoubleLinkBlock)));
-#endif
+	if (m_BlockAmount > MaxCount)
+		throw std::length_error("arena too big for the block count");
+
+	m_pHead = reinterpret_cast<Block*>(AcquireBackingStore(m_BlockAmount * sizeof(Block), m_Store));
 
 	if (!m_pHead)
-		throw std::exception("out of memory");
+		throw std::bad_alloc{};
+
+#ifdef _DEBUG
+	// mapped memory already comes zeroed
+	if (m_Store == eBackingStore::Heap)
+		memset(m_pHead, 0, m_BlockAmount * sizeof(Block));
+#endif
 
 	m_pHead->count = 0;
 	m_pHead->status = Status::reserved;
-	m_pHead->links.pNext = m_pHead + 1;
-	m_pHead->links.pPrevious = m_pHead + 1;
+	m_pHead->previousStatus = Status::reserved;
+	m_pHead->links.pNext = m_pHead;
+	m_pHead->links.pPrevious = m_pHead;
+	m_pRover = m_pHead;
+
+	Block* pFirst = m_pHead + 1;
+	pFirst->previousStatus = Status::reserved;
+	SetFree(pFirst, m_BlockAmount - 1);
+	LinkFree(pFirst);
+}
+
+template<size_t BlockSize, typename THeader>
+BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::~BasicDoubleLinkedListMemoryAllocator()
+{
+	ReleaseBackingStore(reinterpret_cast<void*>(m_pHead), m_BlockAmount * sizeof(Block), m_Store);
+}
 
-	m_pHead->links.pNext->status = Status::free;
-	m_pHead->links.pNext->links.pNext = m_pHead;
-	m_pHead->links.pNext->links.pPrevious = m_pHead;
-	m_pHead->links.pNext->count = m_BlockAmount - 1;
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::Acquire(size_t nbBytes)
+{
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
 }
 
-DoubleLinkedListMemoryAllocator::~DoubleLinkedListMemoryAllocator()
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::Acquire(size_t nbBytes, size_t alignment)
 {
-	free(reinterpret_cast<void*>(m_pHead));
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		throw std::invalid_argument("alignment has to be a power of two");
+
+	void* pData = TryAcquire(nbBytes, alignment);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::TryAcquire(size_t nbBytes) noexcept
+{
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce(nbBytes);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::TryAcquire(size_t nbBytes, size_t alignment) noexcept
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		return nullptr;
+	if (alignment <= sizeof(Header))
+		return TryAcquire(nbBytes);
+
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireAlignedOnce(nbBytes, alignment);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
 }
 
-void* DoubleLinkedListMemoryAllocator::Acquire(size_t nbBytes)
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::AcquireOnce(size_t nbBytes)
 {
-	size_t blockAmount = size_t((nbBytes + sizeof(DoubleLinkHeader) + sizeof(DoubleLinkBlock) - 1) / sizeof(DoubleLinkBlock));
-	DoubleLinkBlock* pCurrent = m_pHead->links.pNext;
-	const DoubleLinkBlock* pEnd = m_pHead + m_BlockAmount;
+	size_t blockAmount = size_t((nbBytes + sizeof(Header) + sizeof(Block) - 1) / sizeof(Block));
+	Block* pCurrent = m_Placement == ePlacement::BestFit ? FindBestFit(blockAmount) : FindFirstFit(blockAmount);
+	if (pCurrent == nullptr)
+		return nullptr;
+
+	// found big enough space
+	if (m_Placement == ePlacement::NextFit)
+		m_pRover = pCurrent->links.pNext;
+	Unlink(pCurrent);
+	const size_t restCount = pCurrent->count - blockAmount;
+	SetReserved(pCurrent, blockAmount);
+	if (restCount)
+	{
+		Block* pNew = pCurrent + blockAmount;
+		SetFree(pNew, restCount);
+		LinkFree(pNew);
+	}
+
+	m_Stats.AddUsed(blockAmount);
+	return pCurrent->data;
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::AcquireAlignedOnce(size_t nbBytes, size_t alignment)
+{
+	Block* pCurrent = m_pHead->links.pNext;
+	const Block* pEnd = m_pHead + m_BlockAmount;
+	Block* pBlock = nullptr;
+	char* pData = nullptr;
+	size_t blockAmount = 0;
 	while (pCurrent != m_pHead)
 	{
-		DoubleLinkBlock* pNext = pCurrent + pCurrent->count;
+		Block* pNext = pCurrent + pCurrent->count;
 		while (pNext < pEnd && pNext->status == Status::free)
 		{
-			pCurrent->count += pNext->count;
 			Unlink(pNext);
+			m_Stats.ResizeFreeRun(pCurrent->count, pCurrent->count + pNext->count);
+			SetFree(pCurrent, pCurrent->count + pNext->count);
 			pNext = pCurrent + pCurrent->count;
 		}
-		if (pCurrent->count >= blockAmount)
+		blockAmount = FitAligned(pCurrent, nbBytes, alignment, pBlock, pData);
+		if (blockAmount)
 			break;
 
 		pCurrent = pCurrent->links.pNext;
 	}
 
-	if (pCurrent->count < blockAmount)
-		throw std::exception("out of memory");
+	if (!blockAmount)
+		return nullptr;
 
-	// found big enough space
-	pCurrent->status = Status::reserved;
-	if (pCurrent->count > blockAmount)
+	// the run is split into a free front, the acquired blocks and a free rest
+	const size_t frontCount = size_t(pBlock - pCurrent);
+	const size_t restCount = pCurrent->count - frontCount - blockAmount;
+	Unlink(pCurrent);
+	if (frontCount)
 	{
-		DoubleLinkBlock* pNew = pCurrent + blockAmount;
-		pNew->status = Status::free;
-		pNew->count = pCurrent->count - blockAmount;
-		pCurrent->count = blockAmount;
-		InsertAfter(pNew, m_pHead);
+		SetFree(pCurrent, frontCount);
+		LinkFree(pCurrent);
+	}
+	SetReserved(pBlock, blockAmount);
+	if (restCount)
+	{
+		Block* pRest = pBlock + blockAmount;
+		SetFree(pRest, restCount);
+		LinkFree(pRest);
 	}
-	Unlink(pCurrent);
 
-#ifdef _DEBUG
-	m_UsedBlocks += blockAmount;
-#endif
-	return pCurrent->data;
+	if (pData != pBlock->data)
+	{
+		// marks the header in front of the data, the real one sits in the block below
+		Header* pMarker = reinterpret_cast<Header*>(pData) - 1;
+		pMarker->status = Status::free;
+		pMarker->previousStatus = Status::reserved;
+		pMarker->count = 0;
+	}
+
+	m_Stats.AddUsed(blockAmount);
+	return pData;
 }
 
-void DoubleLinkedListMemoryAllocator::Release(void* pStart)
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::Release(void* pStart)
 {
 	// Check if pStart is part of buffer
-	if (pStart == nullptr || pStart < m_pHead + 1 || reinterpret_cast<DoubleLinkHeader*>(pStart) - 1 > m_pHead + m_BlockAmount)
+	if (pStart == nullptr || pStart < m_pHead + 1 || reinterpret_cast<Header*>(pStart) - 1 > m_pHead + m_BlockAmount)
 		return;
 
-	DoubleLinkBlock* pBlock = reinterpret_cast<DoubleLinkBlock*>(reinterpret_cast<char*>(pStart) - sizeof(DoubleLinkHeader));
-	InsertAfter(pBlock, m_pHead);
-	pBlock->status = Status::free;
+	ReleaseBlock(GetBlock(pStart));
+}
 
-#ifdef _DEBUG
-	m_UsedBlocks -= pBlock->count;
-#endif
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::AcquireBatch(size_t nbBytes, size_t amount, void** ppOut)
+{
+	const size_t blockAmount = CalculateBlockAmount(nbBytes);
+	size_t acquiredAmount = 0;
+	while (acquiredAmount < amount)
+	{
+		// best fit looks for one run for the whole rest first
+		size_t carveAmount = amount - acquiredAmount;
+		Block* pRun = nullptr;
+		if (m_Placement == ePlacement::BestFit && carveAmount <= m_BlockAmount / blockAmount)
+			pRun = FindBestFit(carveAmount * blockAmount);
+		if (!pRun)
+			pRun = m_Placement == ePlacement::BestFit ? FindBestFit(blockAmount) : FindFirstFit(blockAmount);
+		if (!pRun)
+			break;
+
+		if (m_Placement == ePlacement::NextFit)
+			m_pRover = pRun->links.pNext;
+		Unlink(pRun);
+		Block* pRest = CarveBatch(pRun, blockAmount, carveAmount, ppOut + acquiredAmount);
+		if (pRest)
+			LinkFree(pRest);
+		acquiredAmount += carveAmount;
+	}
+
+	if (acquiredAmount < amount)
+	{
+		ReleaseBatch(ppOut, acquiredAmount);
+		throw std::bad_alloc{};
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::ReleaseBatch(void** ppStarts, size_t amount)
+{
+	// blocks that lie next to each other go back as one run
+	std::sort(ppStarts, ppStarts + amount, std::less<void*>());
+	Block* pGroup = nullptr;
+	size_t groupCount = 0;
+	for (size_t i = 0; i < amount; i++)
+	{
+		void* pStart = ppStarts[i];
+		if (pStart == nullptr || pStart < m_pHead + 1 || reinterpret_cast<Header*>(pStart) - 1 > m_pHead + m_BlockAmount)
+			continue;
+
+		Block* pBlock = GetBlock(pStart);
+		if (pGroup && pGroup + groupCount == pBlock)
+		{
+			groupCount += pBlock->count;
+			continue;
+		}
+		if (pGroup)
+		{
+			SetReserved(pGroup, groupCount);
+			ReleaseBlock(pGroup);
+		}
+		pGroup = pBlock;
+		groupCount = pBlock->count;
+	}
+	if (pGroup)
+	{
+		SetReserved(pGroup, groupCount);
+		ReleaseBlock(pGroup);
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::ReleaseBlock(Block* pBlock)
+{
+	m_Stats.RemoveUsed(pBlock->count);
+	Block* pRun = pBlock;
+	size_t count = pBlock->count;
+	size_t frontCount = 0;
+	size_t behindCount = 0;
+	if (m_Coalescing == eCoalescing::Eager)
+	{
+		// block behind is empty
+		Block* pNext = pBlock + pBlock->count;
+		if (pNext < m_pHead + m_BlockAmount && pNext->status == Status::free)
+		{
+			Unlink(pNext);
+			behindCount = pNext->count;
+			count += behindCount;
+		}
+
+		// block in front is empty, its footer holds its size
+		if (pBlock->previousStatus == Status::free)
+		{
+			pRun = pBlock - (pBlock - 1)->count;
+			Unlink(pRun);
+			frontCount = pRun->count;
+			count += frontCount;
+		}
+	}
+
+	SetFree(pRun, count);
+	LinkFree(pRun);
+	DiscardMerged(pRun, count, frontCount, behindCount);
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::Reallocate(void* pStart, size_t nbBytes)
+{
+	if (pStart == nullptr)
+		return Acquire(nbBytes);
+
+	Block* pBlock = GetBlock(pStart);
+	const size_t blockAmount = GetNeededBlocks(pBlock, pStart, nbBytes);
+	if (blockAmount <= pBlock->count)
+	{
+		ShrinkInPlace(pBlock, blockAmount);
+		return pStart;
+	}
+	if (TryExpandInPlace(pStart, nbBytes))
+		return pStart;
+
+	const size_t oldBytes = size_t(reinterpret_cast<char*>(pBlock + pBlock->count) - static_cast<char*>(pStart));
+	void* pData = Acquire(nbBytes);
+	memcpy(pData, pStart, oldBytes);
+	Release(pStart);
+	return pData;
+}
+
+template<size_t BlockSize, typename THeader>
+bool BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::TryExpandInPlace(void* pStart, size_t nbBytes)
+{
+	if (pStart == nullptr || pStart < m_pHead + 1 || reinterpret_cast<Header*>(pStart) - 1 > m_pHead + m_BlockAmount)
+		return false;
+
+	Block* pBlock = GetBlock(pStart);
+	const size_t blockAmount = GetNeededBlocks(pBlock, pStart, nbBytes);
+	if (blockAmount <= pBlock->count)
+		return true;
+
+	// lazily coalesced runs behind may not be merged yet, they are only taken if they are enough together
+	const Block* pEnd = m_pHead + m_BlockAmount;
+	Block* pBehind = pBlock + pBlock->count;
+	Block* pRunEnd = pBehind;
+	while (pRunEnd < pBlock + blockAmount && pRunEnd < pEnd && pRunEnd->status == Status::free)
+		pRunEnd += pRunEnd->count;
+	if (pRunEnd < pBlock + blockAmount)
+		return false;
+
+	const size_t oldCount = pBlock->count;
+	const size_t count = size_t(pRunEnd - pBlock);
+	for (Block* pRun = pBehind; pRun < pRunEnd; pRun += pRun->count)
+		Unlink(pRun);
+
+	SetReserved(pBlock, blockAmount);
+	if (count > blockAmount)
+	{
+		Block* pRest = pBlock + blockAmount;
+		SetFree(pRest, count - blockAmount);
+		LinkFree(pRest);
+	}
+	m_Stats.AddUsed(blockAmount - oldCount);
+	return true;
+}
+
+template<size_t BlockSize, typename THeader>
+MemoryStats BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::GetStats() const
+{
+	return m_Stats.Snapshot(m_BlockAmount - 1, [this](uint32_t, auto visit)
+	{
+		if (m_Placement == ePlacement::BestFit && m_pTreeRoot)
+		{
+			// the rightmost node of the tree is a largest run
+			const Block* pNode = m_pTreeRoot;
+			while (GetTreeLinks(pNode).pRight)
+				pNode = GetTreeLinks(pNode).pRight;
+			visit(size_t(pNode->count));
+			return;
+		}
+		for (const Block* pRun = m_pHead->links.pNext; pRun != m_pHead; pRun = pRun->links.pNext)
+			visit(size_t(pRun->count));
+	});
 }
 
-std::string DoubleLinkedListMemoryAllocator::UsageToString(const char header, const  char begin, const  char unused, const  char used) const
+template<size_t BlockSize, typename THeader>
+std::string BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::UsageToString(const char header, const  char begin, const  char unused, const  char used) const
 {
 	if (!m_pHead)
 		return "DLLMA | Head is nullptr";
 
 	std::string string{ header };
-	DoubleLinkBlock* pCurrent = m_pHead + 1;
+	Block* pCurrent = m_pHead + 1;
 
-	DoubleLinkBlock* pEnd = m_pHead + m_BlockAmount;
+	Block* pEnd = m_pHead + m_BlockAmount;
 
 	while (pCurrent < pEnd)
 	{
@@ -117,14 +399,16 @@ std::string DoubleLinkedListMemoryAllocator::UsageToString(const char header, co
 	return string;
 }
 
-void DoubleLinkedListMemoryAllocator::Visualize() const
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::Visualize() const
 {
 	std::cout << UsageToString() << std::endl;
 }
 
-void DoubleLinkedListMemoryAllocator::ListAdresses() const
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::ListAdresses() const
 {
-	DoubleLinkBlock* pCurrent = m_pHead;
+	Block* pCurrent = m_pHead;
 	std::cout << "H: " << pCurrent->links.pPrevious << " < " << pCurrent << " > " << pCurrent->links.pNext << std::endl;
 
 	pCurrent = pCurrent->links.pNext;
@@ -138,16 +422,287 @@ void DoubleLinkedListMemoryAllocator::ListAdresses() const
 	std::cout << std::endl;
 }
 
-void DoubleLinkedListMemoryAllocator::Unlink(DoubleLinkBlock* pBlock)
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::FindFirstFit(size_t blockAmount) -> Block*
+{
+	const Block* pEnd = m_pHead + m_BlockAmount;
+	// next fit starts at the rover, when it finds nothing up to the end it searches again from the start
+	Block* pCurrent = m_Placement == ePlacement::NextFit && m_pRover != m_pHead ? m_pRover : m_pHead->links.pNext;
+	bool isWrapped = pCurrent == m_pHead->links.pNext;
+	while (true)
+	{
+		if (pCurrent == m_pHead)
+		{
+			if (isWrapped)
+				return nullptr;
+			isWrapped = true;
+			pCurrent = m_pHead->links.pNext;
+			continue;
+		}
+
+		Block* pNext = pCurrent + pCurrent->count;
+		while (pNext < pEnd && pNext->status == Status::free)
+		{
+			Unlink(pNext);
+			m_Stats.ResizeFreeRun(pCurrent->count, pCurrent->count + pNext->count);
+			SetFree(pCurrent, pCurrent->count + pNext->count);
+			pNext = pCurrent + pCurrent->count;
+		}
+		if (pCurrent->count >= blockAmount)
+			return pCurrent;
+
+		pCurrent = pCurrent->links.pNext;
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::FindBestFit(size_t blockAmount) const -> Block*
+{
+	Block* pFirst = m_pHead->links.pNext;
+	if (blockAmount == 1 && pFirst->count == 1)
+		return pFirst;
+
+	// smallest count that is big enough, the lowest address among equals
+	Block* pBest = nullptr;
+	Block* pNode = m_pTreeRoot;
+	while (pNode)
+	{
+		if (pNode->count >= blockAmount)
+		{
+			pBest = pNode;
+			pNode = GetTreeLinks(pNode).pLeft;
+		}
+		else
+			pNode = GetTreeLinks(pNode).pRight;
+	}
+	return pBest;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::LinkFree(Block* pRun)
+{
+	// best fit takes single blocks from the front, everything else is found through the tree
+	const bool isAtBack = m_Placement == ePlacement::BestFit && pRun->count > 1;
+	InsertAfter(pRun, isAtBack ? m_pHead->links.pPrevious : m_pHead);
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::Unlink(Block* pBlock)
 {
 	pBlock->links.pNext->links.pPrevious = pBlock->links.pPrevious;
 	pBlock->links.pPrevious->links.pNext = pBlock->links.pNext;
+	m_Stats.RemoveFreeRun(pBlock->count);
+	if (m_pRover == pBlock)
+		m_pRover = pBlock->links.pNext;
+	if (m_Placement == ePlacement::BestFit && pBlock->count > 1)
+		m_pTreeRoot = TreeRemove(m_pTreeRoot, pBlock);
 }
 
-void DoubleLinkedListMemoryAllocator::InsertAfter(DoubleLinkBlock* pInsert, DoubleLinkBlock* pPrevious)
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::InsertAfter(Block* pInsert, Block* pPrevious)
 {
 	pPrevious->links.pNext->links.pPrevious = pInsert;
 	pInsert->links.pNext = pPrevious->links.pNext;
 	pInsert->links.pPrevious = pPrevious;
 	pPrevious->links.pNext = pInsert;
+	m_Stats.AddFreeRun(pInsert->count);
+	if (m_Placement == ePlacement::BestFit && pInsert->count > 1)
+		m_pTreeRoot = TreeInsert(m_pTreeRoot, pInsert);
 }
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::SetFree(Block* pBlock, size_t count)
+{
+	pBlock->status = Status::free;
+	pBlock->count = count;
+	(pBlock + count - 1)->count = count;
+
+	Block* pNext = pBlock + count;
+	if (pNext < m_pHead + m_BlockAmount)
+		pNext->previousStatus = Status::free;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::SetReserved(Block* pBlock, size_t count)
+{
+	pBlock->status = Status::reserved;
+	pBlock->count = count;
+
+	Block* pNext = pBlock + count;
+	if (pNext < m_pHead + m_BlockAmount)
+		pNext->previousStatus = Status::reserved;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::DiscardMerged(Block* pRun, size_t count, size_t frontCount, size_t behindCount) const
+{
+	if (m_Store == eBackingStore::Heap || count * sizeof(Block) < m_DiscardBytes)
+		return;
+
+	// the first block keeps the links, the second the tree node and the last one the footer;
+	// neighbours that already were large got their pages discarded when they were freed
+	const size_t largeCount = std::max(m_DiscardBytes / sizeof(Block), size_t(3));
+	Block* pFrom = frontCount >= largeCount ? pRun + frontCount - 1 : pRun + 2;
+	Block* pTo = behindCount >= largeCount ? pRun + count - behindCount + 1 : pRun + count - 1;
+	if (pFrom < pTo)
+		DiscardPages(pFrom, (pTo - pFrom) * sizeof(Block), m_Store);
+}
+
+template<size_t BlockSize, typename THeader>
+size_t BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::FitAligned(Block* pRun, size_t nbBytes, size_t alignment, Block*& pBlock, char*& pData) const
+{
+	uintptr_t data = reinterpret_cast<uintptr_t>(pRun->data);
+	pBlock = pRun;
+	if (data % alignment != 0)
+	{
+		// leave room for a marker header between the real header and the aligned data
+		data = (data + sizeof(Header) + alignment - 1) & ~uintptr_t(alignment - 1);
+		pBlock = m_pHead + (data - 2 * sizeof(Header) - reinterpret_cast<uintptr_t>(m_pHead)) / sizeof(Block);
+	}
+
+	const uintptr_t end = reinterpret_cast<uintptr_t>(pRun + pRun->count);
+	if (data >= end || nbBytes > end - data)
+		return 0;
+
+	pData = reinterpret_cast<char*>(data);
+	return (data + nbBytes - reinterpret_cast<uintptr_t>(pBlock) + sizeof(Block) - 1) / sizeof(Block);
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::GetBlock(void* pStart) const -> Block*
+{
+	Header* pHeader = reinterpret_cast<Header*>(pStart) - 1;
+	if (pHeader->status == Status::reserved)
+		return reinterpret_cast<Block*>(pHeader);
+
+	// marker of an aligned acquisition
+	const uintptr_t header = reinterpret_cast<uintptr_t>(pStart) - 2 * sizeof(Header);
+	return m_pHead + (header - reinterpret_cast<uintptr_t>(m_pHead)) / sizeof(Block);
+}
+
+template<size_t BlockSize, typename THeader>
+uint32_t BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::GetTreePriority(const Block* pRun)
+{
+	// the address is random enough once mixed, so no priority has to be stored
+	uint64_t hash = uint64_t(reinterpret_cast<uintptr_t>(pRun));
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	return uint32_t(hash);
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::TreeInsert(Block* pRoot, Block* pRun) -> Block*
+{
+	if (!pRoot)
+	{
+		GetTreeLinks(pRun) = { nullptr, nullptr };
+		return pRun;
+	}
+
+	TreeLinks& rootLinks = GetTreeLinks(pRoot);
+	if (IsTreeLess(pRun, pRoot))
+	{
+		rootLinks.pLeft = TreeInsert(rootLinks.pLeft, pRun);
+		if (GetTreePriority(rootLinks.pLeft) > GetTreePriority(pRoot))
+		{
+			// rotate right
+			Block* pLeft = rootLinks.pLeft;
+			rootLinks.pLeft = GetTreeLinks(pLeft).pRight;
+			GetTreeLinks(pLeft).pRight = pRoot;
+			return pLeft;
+		}
+	}
+	else
+	{
+		rootLinks.pRight = TreeInsert(rootLinks.pRight, pRun);
+		if (GetTreePriority(rootLinks.pRight) > GetTreePriority(pRoot))
+		{
+			// rotate left
+			Block* pRight = rootLinks.pRight;
+			rootLinks.pRight = GetTreeLinks(pRight).pLeft;
+			GetTreeLinks(pRight).pLeft = pRoot;
+			return pRight;
+		}
+	}
+	return pRoot;
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::TreeRemove(Block* pRoot, Block* pRun) -> Block*
+{
+	if (pRoot == pRun)
+		return TreeMerge(GetTreeLinks(pRoot).pLeft, GetTreeLinks(pRoot).pRight);
+
+	TreeLinks& rootLinks = GetTreeLinks(pRoot);
+	if (IsTreeLess(pRun, pRoot))
+		rootLinks.pLeft = TreeRemove(rootLinks.pLeft, pRun);
+	else
+		rootLinks.pRight = TreeRemove(rootLinks.pRight, pRun);
+	return pRoot;
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::TreeMerge(Block* pLeft, Block* pRight) -> Block*
+{
+	if (!pLeft)
+		return pRight;
+	if (!pRight)
+		return pLeft;
+
+	if (GetTreePriority(pLeft) > GetTreePriority(pRight))
+	{
+		GetTreeLinks(pLeft).pRight = TreeMerge(GetTreeLinks(pLeft).pRight, pRight);
+		return pLeft;
+	}
+	GetTreeLinks(pRight).pLeft = TreeMerge(pLeft, GetTreeLinks(pRight).pLeft);
+	return pRight;
+}
+
+template<size_t BlockSize, typename THeader>
+size_t BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::GetNeededBlocks(const Block* pBlock, const void* pStart, size_t nbBytes)
+{
+	// aligned acquisitions start further into their block
+	const size_t offset = size_t(static_cast<const char*>(pStart) - reinterpret_cast<const char*>(pBlock));
+	return (offset + nbBytes + sizeof(Block) - 1) / sizeof(Block);
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::ShrinkInPlace(Block* pBlock, size_t blockAmount)
+{
+	const size_t restCount = pBlock->count - blockAmount;
+	if (restCount == 0)
+		return;
+
+	// the tail becomes a block of its own and is released, so it merges like any other
+	SetReserved(pBlock, blockAmount);
+	Block* pRest = pBlock + blockAmount;
+	SetReserved(pRest, restCount);
+	ReleaseBlock(pRest);
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicDoubleLinkedListMemoryAllocator<BlockSize, THeader>::CarveBatch(Block* pRun, size_t blockAmount, size_t& amount, void** ppOut) -> Block*
+{
+	const size_t runCount = pRun->count;
+	amount = std::min(amount, runCount / blockAmount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		Block* pBlock = pRun + i * blockAmount;
+		SetReserved(pBlock, blockAmount);
+		ppOut[i] = pBlock->data;
+	}
+	m_Stats.AddUsed(amount * blockAmount);
+
+	const size_t restCount = runCount - amount * blockAmount;
+	if (restCount == 0)
+		return nullptr;
+
+	Block* pRest = pRun + amount * blockAmount;
+	SetFree(pRest, restCount);
+	return pRest;
+}
+
+template class BasicDoubleLinkedListMemoryAllocator<DoubleLinkBlock::size, DoubleLinkHeader>;
+template class BasicDoubleLinkedListMemoryAllocator<32, BasicDoubleLinkHeader<uint32_t>>;
+template class BasicDoubleLinkedListMemoryAllocator<64, DoubleLinkHeader>;
@@ -1,30 +1,118 @@
 #pragma once
 #include "MemoryAllocator.h"
+#include "MemoryBlock.h"
+#include "BackingStore.h"
+#include "MemoryStats.h"
+#include "PlacementPolicy.h"
+#include "OutOfMemoryHandler.h"
 #include <string>
-class DoubleLinkedListMemoryAllocator : public MemoryAllocator
+
+enum class eCoalescing
+{
+	Lazy,	// Release only links the block, neighbours are merged while Acquire walks the list
+	Eager,	// Release merges both neighbours right away through the boundary tags
+};
+
+// THeader is a BasicDoubleLinkHeader, its count type limits the arena to 2^(digits - 2) blocks;
+// member definitions live in the .cpp, only the instantiations listed there are available
+template<size_t BlockSize, typename THeader = DoubleLinkHeader>
+class BasicDoubleLinkedListMemoryAllocator : public MemoryAllocator
 {
 public:
-	DoubleLinkedListMemoryAllocator(size_t blockAmount);
-	virtual ~DoubleLinkedListMemoryAllocator();
+	using Header = THeader;
+	using Block = BasicDoubleLinkBlock<BlockSize, THeader>;
+	static_assert(sizeof(Block) == BlockSize, "block layout does not add up to the block size");
+	static_assert(sizeof(Header) % alignof(void*) == 0, "data has to start right behind the header");
+
+	// best fit always coalesces eagerly, its index cannot follow runs that grow while they are linked
+	BasicDoubleLinkedListMemoryAllocator(size_t nbBytes, eCoalescing coalescing = eCoalescing::Lazy, ePlacement placement = ePlacement::FirstFit, eBackingStore store = eBackingStore::Heap);
+	virtual ~BasicDoubleLinkedListMemoryAllocator();
 	virtual void* Acquire(size_t nbBytes = 0) override;
+	// alignment has to be a power of two, Release takes the aligned pointer as is
+	void* Acquire(size_t nbBytes, size_t alignment);
+	// like Acquire, but returns nullptr once the out of memory handler gives up (or for a bad alignment)
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	void* TryAcquire(size_t nbBytes, size_t alignment) noexcept;
 	virtual void Release(void* pStart) override;
-	DoubleLinkBlock* GetHead() const { return m_pHead; };
+	// acquires amount blocks of nbBytes carved from as few runs as possible, all or nothing
+	void AcquireBatch(size_t nbBytes, size_t amount, void** ppOut);
+	// sorts ppStarts by address
+	void ReleaseBatch(void** ppStarts, size_t amount);
+	// grows or shrinks in place when possible, otherwise acquires, copies and releases;
+	// the old block stays valid when that throws, a moved block only keeps the default alignment
+	void* Reallocate(void* pStart, size_t nbBytes);
+	// takes blocks from the free runs behind, true when pStart now holds nbBytes
+	bool TryExpandInPlace(void* pStart, size_t nbBytes);
+	Block* GetHead() const { return m_pHead; };
 	size_t GetBlockAmount() const { return m_BlockAmount; };
+	eCoalescing GetCoalescing() const { return m_Coalescing; };
+	ePlacement GetPlacement() const { return m_Placement; };
+	eBackingStore GetBackingStore() const { return m_Store; };
+	// runs that are next to each other but not merged yet count as separate runs
+	MemoryStats GetStats() const;
+	// free runs of at least this size get their pages handed back to the OS, mapped stores only
+	void SetDiscardThreshold(size_t nbBytes) { m_DiscardBytes = nbBytes; };
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
 	std::string UsageToString(const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
 	void Visualize() const;
 	void ListAdresses() const;
 	inline static size_t CalculateBlockAmount(const size_t nbBytes)
 	{
-		return size_t((nbBytes + sizeof(DoubleLinkHeader) + sizeof(DoubleLinkBlock) - 1) / sizeof(DoubleLinkBlock));
+		return size_t((nbBytes + sizeof(Header) + sizeof(Block) - 1) / sizeof(Block));
 	};
 private:
-	DoubleLinkBlock* m_pHead;
+	// largest run the count bitfield can hold
+	enum : size_t { MaxCount = std::numeric_limits<typename THeader::Count>::max() >> 2 };
+
+	Block* m_pHead;
 	size_t m_BlockAmount;
-#ifdef _DEBUG
-	size_t m_UsedBlocks;
-#endif
+	ePlacement m_Placement;
+	eCoalescing m_Coalescing;
+	// next fit continues at this run, the head means from the start
+	Block* m_pRover;
+	// best fit: treap of the runs of 2 blocks or more ordered by count, then address,
+	// the node lives in the second block of the run, single blocks stay at the front of the list
+	Block* m_pTreeRoot;
+	eBackingStore m_Store;
+	size_t m_DiscardBytes;
+	MemoryStatsCounter m_Stats;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	struct TreeLinks
+	{
+		Block* pLeft;
+		Block* pRight;
+	};
 
-	void Unlink(DoubleLinkBlock* pBlock);
-	void InsertAfter(DoubleLinkBlock* pInsert, DoubleLinkBlock* pPrevious);
+	Block* FindFirstFit(size_t blockAmount);
+	Block* FindBestFit(size_t blockAmount) const;
+	void LinkFree(Block* pRun);
+	void ReleaseBlock(Block* pBlock);
+	// splits a run that is out of the list into up to amount blocks, returns the free rest or nullptr
+	Block* CarveBatch(Block* pRun, size_t blockAmount, size_t& amount, void** ppOut);
+	void Unlink(Block* pBlock);
+	void InsertAfter(Block* pInsert, Block* pPrevious);
+	// a single search without the handler, nullptr when nothing fits
+	void* AcquireOnce(size_t nbBytes);
+	void* AcquireAlignedOnce(size_t nbBytes, size_t alignment);
+	void SetFree(Block* pBlock, size_t count);
+	void SetReserved(Block* pBlock, size_t count);
+	void DiscardMerged(Block* pRun, size_t count, size_t frontCount, size_t behindCount) const;
+	size_t FitAligned(Block* pRun, size_t nbBytes, size_t alignment, Block*& pBlock, char*& pData) const;
+	Block* GetBlock(void* pStart) const;
+	static size_t GetNeededBlocks(const Block* pBlock, const void* pStart, size_t nbBytes);
+	void ShrinkInPlace(Block* pBlock, size_t blockAmount);
+	static TreeLinks& GetTreeLinks(Block* pRun) { return *reinterpret_cast<TreeLinks*>((pRun + 1)->data); };
+	static const TreeLinks& GetTreeLinks(const Block* pRun) { return *reinterpret_cast<const TreeLinks*>((pRun + 1)->data); };
+	static bool IsTreeLess(const Block* pA, const Block* pB) { return pA->count < pB->count || (pA->count == pB->count && pA < pB); };
+	static uint32_t GetTreePriority(const Block* pRun);
+	static Block* TreeInsert(Block* pRoot, Block* pRun);
+	static Block* TreeRemove(Block* pRoot, Block* pRun);
+	static Block* TreeMerge(Block* pLeft, Block* pRight);
 };
 
+using DoubleLinkedListMemoryAllocator = BasicDoubleLinkedListMemoryAllocator<DoubleLinkBlock::size, DoubleLinkHeader>;
+// 32 bit counts, up to 32 GiB, for arenas of small objects
+using SmallDoubleLinkedListMemoryAllocator = BasicDoubleLinkedListMemoryAllocator<32, BasicDoubleLinkHeader<uint32_t>>;
+// one cache line per block, for arenas of large objects
+using CacheLineDoubleLinkedListMemoryAllocator = BasicDoubleLinkedListMemoryAllocator<64, DoubleLinkHeader>;
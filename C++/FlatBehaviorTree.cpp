@@ -0,0 +1,121 @@
+#include "stdafx.h"
+#include "FlatBehaviorTree.h"
+#include "EBlackboard.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Elite;
+
+FlatBehaviorTree::FlatBehaviorTree(Blackboard* pBlackboard, const Desc& root)
+	: m_pBlackboard{ pBlackboard }
+	, m_State{ BehaviorState::Failure }
+	, m_Entry{ Failed }
+{
+	AddLeaves(root);
+	size_t end = m_Leaves.size();
+	m_Entry = Link(root, Succeeded, Failed, end);
+}
+
+FlatBehaviorTree::~FlatBehaviorTree()
+{
+	SAFE_DELETE(m_pBlackboard);
+}
+
+BehaviorState FlatBehaviorTree::Update()
+{
+	const Leaf* pLeaves = m_Leaves.data();
+	uint16_t idx = m_Entry;
+	while (idx < Failed)
+	{
+		const Leaf& leaf = pLeaves[idx];
+		bool hasSucceeded;
+		if (leaf.type == eFlatBehavior::Flag)
+			hasSucceeded = *m_Flags[leaf.function];
+		else if (leaf.type == eFlatBehavior::Conditional)
+			hasSucceeded = m_Conditionals[leaf.function](m_pBlackboard);
+		else
+		{
+			const BehaviorState state = m_Actions[leaf.function](m_pBlackboard);
+			// stops a sequence and a selector alike, so it goes all the way up
+			if (state == BehaviorState::Running)
+				return m_State = state;
+			hasSucceeded = state == BehaviorState::Success;
+		}
+		idx = hasSucceeded ? leaf.onSuccess : leaf.onFailure;
+	}
+	return m_State = idx == Succeeded ? BehaviorState::Success : BehaviorState::Failure;
+}
+
+void FlatBehaviorTree::AddLeaves(const Desc& desc)
+{
+	switch (desc.type)
+	{
+	case eFlatBehavior::Sequence:
+	case eFlatBehavior::Selector:
+		for (const Desc& child : desc.children)
+			AddLeaves(child);
+		return;
+	case eFlatBehavior::Conditional:
+		if (!desc.conditional)
+			throw std::invalid_argument("FlatBehaviorTree: conditional without a function");
+		break;
+	case eFlatBehavior::Action:
+		if (!desc.action)
+			throw std::invalid_argument("FlatBehaviorTree: action without a function");
+		break;
+	case eFlatBehavior::Flag:
+		if (!desc.pFlag)
+			throw std::invalid_argument("FlatBehaviorTree: flag without a value");
+		break;
+	}
+	if (m_Leaves.size() >= Failed)
+		throw std::length_error("FlatBehaviorTree: too many leaves");
+
+	Leaf leaf{ desc.type, 0, Succeeded, Failed };
+	if (desc.type == eFlatBehavior::Flag)
+		leaf.function = IndexOf(m_Flags, desc.pFlag);
+	else if (desc.type == eFlatBehavior::Conditional)
+		leaf.function = IndexOf(m_Conditionals, desc.conditional);
+	else
+		leaf.function = IndexOf(m_Actions, desc.action);
+	m_Leaves.push_back(leaf);
+}
+
+uint16_t FlatBehaviorTree::Link(const Desc& desc, uint16_t onSuccess, uint16_t onFailure, size_t& end)
+{
+	// children go back to front, so each one already knows where its next sibling starts
+	uint16_t start;
+	switch (desc.type)
+	{
+	case eFlatBehavior::Sequence:
+		// a success goes on with the next child, the last one's success is the sequence's
+		start = onSuccess;
+		for (auto it = desc.children.rbegin(); it != desc.children.rend(); ++it)
+			start = Link(*it, start, onFailure, end);
+		return start;
+	case eFlatBehavior::Selector:
+		// a failure goes on with the next child, the last one's failure is the selector's
+		start = onFailure;
+		for (auto it = desc.children.rbegin(); it != desc.children.rend(); ++it)
+			start = Link(*it, onSuccess, start, end);
+		return start;
+	default:
+		start = uint16_t(--end);
+		// an inverted flag is a flag with its targets swapped, the update does not know
+		m_Leaves[start].onSuccess = desc.isInverted ? onFailure : onSuccess;
+		m_Leaves[start].onFailure = desc.isInverted ? onSuccess : onFailure;
+		return start;
+	}
+}
+
+template<typename TFn>
+uint16_t FlatBehaviorTree::IndexOf(std::vector<TFn>& functions, TFn function)
+{
+	// leaves sharing a function share its entry, the table stays small
+	auto it = std::find(functions.begin(), functions.end(), function);
+	if (it != functions.end())
+		return uint16_t(it - functions.begin());
+
+	functions.push_back(function);
+	return uint16_t(functions.size() - 1);
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "EBehaviorTree.h"
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace Elite
+{
+	class Blackboard;
+}
+
+enum class eFlatBehavior : uint8_t
+{
+	Sequence,
+	Selector,
+	Conditional,
+	Action,
+	// a conditional that only reads a bool, like a slot of a TypedBlackboard
+	Flag,
+};
+
+// A behavior tree lowered into an array of its leaves in pre-order. Whether a composite goes
+// on with its next child or hands its result up only depends on the result of the child, so
+// every leaf already knows where to go after a success and after a failure: the next leaf to
+// run or the result of the whole tree. An update runs the leaves one after the other, only
+// jumping forward over the ones a decided composite skips, without composites to walk through.
+// Leaves hold an index into a table of plain function pointers, or of bools for flags.
+// Sequence, selector, conditional and action behave like the Elite nodes, Running ends the update.
+class FlatBehaviorTree
+{
+public:
+	using ConditionalFn = bool(*)(Elite::Blackboard*);
+	using ActionFn = Elite::BehaviorState(*)(Elite::Blackboard*);
+
+	// description of a tree, only used to build one
+	struct Desc
+	{
+		eFlatBehavior type;
+		ConditionalFn conditional;
+		ActionFn action;
+		std::vector<Desc> children;
+		const bool* pFlag = nullptr;
+		// the flag succeeds when it is false
+		bool isInverted = false;
+	};
+
+	static Desc Sequence(std::initializer_list<Desc> children) { return { eFlatBehavior::Sequence, nullptr, nullptr, children }; };
+	static Desc Selector(std::initializer_list<Desc> children) { return { eFlatBehavior::Selector, nullptr, nullptr, children }; };
+	static Desc Conditional(ConditionalFn conditional) { return { eFlatBehavior::Conditional, conditional, nullptr, {} }; };
+	static Desc Action(ActionFn action) { return { eFlatBehavior::Action, nullptr, action, {} }; };
+	// pFlag is read on every update, it has to outlive the tree
+	static Desc Flag(const bool* pFlag, bool isSet = true) { return { eFlatBehavior::Flag, nullptr, nullptr, {}, pFlag, !isSet }; };
+
+	// takes ownership of the blackboard, like Elite::BehaviorTree
+	FlatBehaviorTree(Elite::Blackboard* pBlackboard, const Desc& root);
+	~FlatBehaviorTree();
+
+	Elite::BehaviorState Update();
+	Elite::BehaviorState GetState() const { return m_State; };
+	Elite::Blackboard* GetBlackboard() const { return m_pBlackboard; };
+	size_t GetLeafAmount() const { return m_Leaves.size(); };
+
+	FlatBehaviorTree(const FlatBehaviorTree& other) = delete;
+	FlatBehaviorTree(FlatBehaviorTree&& other) = delete;
+	FlatBehaviorTree& operator=(const FlatBehaviorTree& other) = delete;
+	FlatBehaviorTree& operator=(FlatBehaviorTree&& other) = delete;
+
+private:
+	// jump targets past the leaves, the update ends with this result
+	enum : uint16_t { Succeeded = UINT16_MAX, Failed = UINT16_MAX - 1 };
+
+	struct Leaf
+	{
+		eFlatBehavior type;
+		// into m_Conditionals, m_Actions or m_Flags
+		uint16_t function;
+		uint16_t onSuccess;
+		uint16_t onFailure;
+	};
+
+	Elite::Blackboard* m_pBlackboard;
+	Elite::BehaviorState m_State;
+	std::vector<Leaf> m_Leaves;
+	std::vector<ConditionalFn> m_Conditionals;
+	std::vector<ActionFn> m_Actions;
+	std::vector<const bool*> m_Flags;
+	uint16_t m_Entry;
+
+	// adds the leaves of desc in pre-order
+	void AddLeaves(const Desc& desc);
+	// points the leaves of desc at the targets after it, walking back from end, returns where desc starts
+	uint16_t Link(const Desc& desc, uint16_t onSuccess, uint16_t onFailure, size_t& end);
+	template<typename TFn>
+	static uint16_t IndexOf(std::vector<TFn>& functions, TFn function);
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "Exam_HelperStructs.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+// key of a cell of a uniform grid hashed into an unordered_map
+inline uint64_t ToGridKey(int x, int y)
+{
+	return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+}
+
+// the cells of a grid that hold anything lie inside these bounds
+struct GridBounds
+{
+	int minX = INT_MAX;
+	int minY = INT_MAX;
+	int maxX = INT_MIN;
+	int maxY = INT_MIN;
+
+	bool IsEmpty() const { return minX > maxX; };
+	void Reset() { *this = GridBounds{}; };
+	void Add(int x, int y)
+	{
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+	};
+};
+
+// Calls visit(entries, minSq) for the cells of a grid that can hold the entry nearest to pos,
+// visit lowers minSq to the squared distance of the nearest entry it accepts. Rings around pos
+// start where the bounds begin and are clipped to them, so the cost follows the occupied area
+// rather than the distance to it. Grids with few occupied cells are walked whole instead.
+template<typename TCells, typename TVisit>
+void VisitNearestCells(const TCells& cells, const GridBounds& bounds, float cellSize, const Elite::Vector2& pos, TVisit visit)
+{
+	enum : size_t { LinearCellAmount = 16 };
+
+	float minSq = FLT_MAX;
+	if (cells.size() <= LinearCellAmount)
+	{
+		for (const auto& cell : cells)
+			visit(cell.second, minSq);
+		return;
+	}
+
+	const int centerX = int(floorf(pos.x / cellSize));
+	const int centerY = int(floorf(pos.y / cellSize));
+	// rings closer than the bounds are empty, rings past the farthest corner too
+	const int firstRing = std::max(std::max(std::max(bounds.minX - centerX, centerX - bounds.maxX), std::max(bounds.minY - centerY, centerY - bounds.maxY)), 0);
+	const int lastRing = std::max(std::max(centerX - bounds.minX, bounds.maxX - centerX), std::max(centerY - bounds.minY, bounds.maxY - centerY));
+	auto visitCell = [&cells, &visit, &minSq](int x, int y)
+	{
+		auto it = cells.find(ToGridKey(x, y));
+		if (it != cells.end())
+			visit(it->second, minSq);
+	};
+
+	for (int ring = firstRing; ring <= lastRing; ring++)
+	{
+		const int left = centerX - ring;
+		const int right = centerX + ring;
+		const int top = centerY - ring;
+		const int bottom = centerY + ring;
+		const int startX = std::max(left, bounds.minX);
+		const int endX = std::min(right, bounds.maxX);
+		const int endY = std::min(bottom, bounds.maxY);
+		for (int y = std::max(top, bounds.minY); y <= endY; y++)
+		{
+			if (y == top || y == bottom)
+			{
+				for (int x = startX; x <= endX; x++)
+					visitCell(x, y);
+				continue;
+			}
+
+			// inner rows only have the two cells on the edge of the ring
+			if (left >= bounds.minX)
+				visitCell(left, y);
+			if (right <= bounds.maxX)
+				visitCell(right, y);
+		}
+
+		// every cell of the next ring is at least ring cells away
+		const float ringDistance = float(ring) * cellSize;
+		if (minSq <= ringDistance * ringDistance)
+			break;
+	}
+}
@@ -0,0 +1,109 @@
+#include "stdafx.h"
+#include "HouseIndex.h"
+#include <algorithm>
+
+using namespace Elite;
+
+HouseIndex::HouseIndex(float cellSize)
+	: m_CellSize{ cellSize }
+{}
+
+int HouseIndex::Find(const Vector2& center) const
+{
+	auto it = m_Centers.find(ToKey(center));
+	return it != m_Centers.end() ? it->second : -1;
+}
+
+int HouseIndex::Add(const HouseInfoExtended& house)
+{
+	const int idx = int(m_Houses.size());
+	m_Houses.push_back(house);
+	m_Centers.emplace(ToKey(house.Center), idx);
+	m_VisitOrder.emplace(house.ItemsPickedUp, idx);
+
+	const Vector2 half = house.Size / 2.f;
+	const int endX = ToCell(house.Center.x + half.x);
+	const int endY = ToCell(house.Center.y + half.y);
+	for (int y = ToCell(house.Center.y - half.y); y <= endY; y++)
+	{
+		for (int x = ToCell(house.Center.x - half.x); x <= endX; x++)
+			m_AreaCells[ToKey(x, y)].push_back(idx);
+	}
+
+	const int x = ToCell(house.Center.x);
+	const int y = ToCell(house.Center.y);
+	m_CenterCells[ToKey(x, y)].push_back(idx);
+	m_CenterBounds.Add(x, y);
+	return idx;
+}
+
+void HouseIndex::SetItemsPickedUp(size_t idx, int itemsPickedUp)
+{
+	HouseInfoExtended& house = m_Houses[idx];
+	if (house.ItemsPickedUp == itemsPickedUp)
+		return;
+
+	m_VisitOrder.erase({ house.ItemsPickedUp, int(idx) });
+	house.ItemsPickedUp = itemsPickedUp;
+	m_VisitOrder.emplace(itemsPickedUp, int(idx));
+}
+
+int HouseIndex::GetNearest(const Vector2& pos, int ignoreIdx) const
+{
+	return FindNearest(pos, [ignoreIdx](int idx) { return idx != ignoreIdx; });
+}
+
+int HouseIndex::GetOldestVisited(const Vector2& pos, int ignoreIdx) const
+{
+	auto it = m_VisitOrder.begin();
+	if (it != m_VisitOrder.end() && it->second == ignoreIdx)
+		++it;
+	if (it == m_VisitOrder.end())
+		return -1;
+
+	// most of the time the oldest is on its own, unvisited houses all share the same count
+	const int itemsPickedUp = it->first;
+	auto itNext = std::next(it);
+	if (itNext != m_VisitOrder.end() && itNext->second == ignoreIdx)
+		++itNext;
+	if (itNext == m_VisitOrder.end() || itNext->first != itemsPickedUp)
+		return it->second;
+
+	return FindNearest(pos, [this, ignoreIdx, itemsPickedUp](int idx) { return idx != ignoreIdx && m_Houses[idx].ItemsPickedUp == itemsPickedUp; });
+}
+
+uint64_t HouseIndex::ToKey(const Vector2& center)
+{
+	// + 0.f turns -0 into 0, so the key matches exactly when the centers compare equal
+	const float x = center.x + 0.f;
+	const float y = center.y + 0.f;
+	uint32_t xBits;
+	uint32_t yBits;
+	memcpy(&xBits, &x, sizeof(xBits));
+	memcpy(&yBits, &y, sizeof(yBits));
+	return (uint64_t(xBits) << 32) | yBits;
+}
+
+template<typename TPredicate>
+int HouseIndex::FindNearest(const Vector2& pos, TPredicate isAccepted) const
+{
+	if (m_Houses.empty())
+		return -1;
+
+	int nearestIdx = -1;
+	VisitNearestCells(m_CenterCells, m_CenterBounds, m_CellSize, pos, [this, &pos, &isAccepted, &nearestIdx](const std::vector<int>& houses, float& minSq)
+	{
+		for (int idx : houses)
+		{
+			if (!isAccepted(idx))
+				continue;
+			const float disSq = pos.DistanceSquared(m_Houses[idx].Center);
+			if (disSq < minSq)
+			{
+				minSq = disSq;
+				nearestIdx = idx;
+			}
+		}
+	});
+	return nearestIdx;
+}
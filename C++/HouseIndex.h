@@ -0,0 +1,76 @@
+#pragma once
+#include "stdafx.h"
+#include "Exam_HelperStructs.h"
+#include "HelperFunctions.h"
+#include "GridSearch.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct HouseInfoExtended : HouseInfo
+{
+	int ItemsPickedUp;
+	Elite::Vector2 Corners[4];
+	bool CornersSeen[4];
+};
+
+// The houses the brain knows. Centers are hashed for exact lookups, bounds are entered into
+// every grid cell they overlap for containment tests, centers into one cell each for nearest
+// queries, and the houses are ordered by ItemsPickedUp for the one visited longest ago.
+// Houses are never removed, so an index stays valid.
+class HouseIndex
+{
+public:
+	explicit HouseIndex(float cellSize = 32.f);
+
+	// -1 when no house has this center
+	int Find(const Elite::Vector2& center) const;
+	int Add(const HouseInfoExtended& house);
+	size_t GetAmount() const { return m_Houses.size(); };
+	// ItemsPickedUp orders the houses, change it through SetItemsPickedUp only
+	HouseInfoExtended& operator[](size_t idx) { return m_Houses[idx]; };
+	const HouseInfoExtended& operator[](size_t idx) const { return m_Houses[idx]; };
+	void SetItemsPickedUp(size_t idx, int itemsPickedUp);
+
+	// func(idx) for every house whose bounds hold pos
+	template<typename TFunc>
+	void ForEachContaining(const Elite::Vector2& pos, TFunc func) const
+	{
+		auto it = m_AreaCells.find(ToKey(ToCell(pos.x), ToCell(pos.y)));
+		if (it == m_AreaCells.end())
+			return;
+
+		for (int idx : it->second)
+		{
+			if (InBounds(pos, m_Houses[idx].Center, m_Houses[idx].Size))
+				func(idx);
+		}
+	};
+
+	// the house with the nearest center other than ignoreIdx, -1 when there is none
+	int GetNearest(const Elite::Vector2& pos, int ignoreIdx) const;
+	// the house with the fewest ItemsPickedUp other than ignoreIdx, the nearest of those on a tie
+	int GetOldestVisited(const Elite::Vector2& pos, int ignoreIdx) const;
+
+private:
+	const float m_CellSize;
+	std::vector<HouseInfoExtended> m_Houses;
+	std::unordered_map<uint64_t, int> m_Centers;
+	std::unordered_map<uint64_t, std::vector<int>> m_AreaCells;
+	std::unordered_map<uint64_t, std::vector<int>> m_CenterCells;
+	// bounds of the center cells
+	GridBounds m_CenterBounds;
+	// (ItemsPickedUp, idx)
+	std::set<std::pair<int, int>> m_VisitOrder;
+
+	int ToCell(float coordinate) const { return int(floorf(coordinate / m_CellSize)); };
+	static uint64_t ToKey(int x, int y) { return ToGridKey(x, y); };
+	static uint64_t ToKey(const Elite::Vector2& center);
+	// nearest center among the houses isAccepted(idx) is true for, -1 when there is none
+	template<typename TPredicate>
+	int FindNearest(const Elite::Vector2& pos, TPredicate isAccepted) const;
+};
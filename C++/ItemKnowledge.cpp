@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "ItemKnowledge.h"
+#include <algorithm>
+
+using namespace Elite;
+
+ItemKnowledge::ItemKnowledge(float cellSize)
+	: m_CellSize{ cellSize }
+{}
+
+bool ItemKnowledge::Insert(const Vector2& location, eItemType type)
+{
+	eItemType knownType;
+	if (FindType(location, knownType))
+		return false;
+
+	Add(location, type);
+	return true;
+}
+
+void ItemKnowledge::Set(const Vector2& location, eItemType type)
+{
+	eItemType knownType;
+	if (FindType(location, knownType))
+	{
+		if (knownType == type)
+			return;
+		Erase(location, knownType);
+	}
+	Add(location, type);
+}
+
+bool ItemKnowledge::Remove(const Vector2& location)
+{
+	eItemType type;
+	if (!FindType(location, type))
+		return false;
+
+	Erase(location, type);
+	return true;
+}
+
+bool ItemKnowledge::Contains(const Vector2& location) const
+{
+	eItemType type;
+	return FindType(location, type);
+}
+
+bool ItemKnowledge::Find(const Vector2& location, eItemType& type) const
+{
+	return FindType(location, type);
+}
+
+bool ItemKnowledge::GetNearest(const Vector2& pos, eItemType type, Vector2& nearest) const
+{
+	if (GetAmount(type) == 0)
+		return false;
+
+	const Grid& grid = m_Grids[size_t(type)];
+	VisitNearestCells(grid.cells, grid.bounds, m_CellSize, pos, [&pos, &nearest](const std::vector<Vector2>& locations, float& minSq)
+	{
+		for (const Vector2& location : locations)
+		{
+			const float disSq = pos.DistanceSquared(location);
+			if (disSq < minSq)
+			{
+				minSq = disSq;
+				nearest = location;
+			}
+		}
+	});
+	return true;
+}
+
+size_t ItemKnowledge::GetAmount(eItemType type) const
+{
+	return size_t(type) < m_Grids.size() ? m_Grids[size_t(type)].amount : 0;
+}
+
+void ItemKnowledge::Add(const Vector2& location, eItemType type)
+{
+	if (size_t(type) >= m_Grids.size())
+		m_Grids.resize(size_t(type) + 1);
+
+	Grid& grid = m_Grids[size_t(type)];
+	const int x = ToCell(location.x);
+	const int y = ToCell(location.y);
+	grid.cells[ToKey(x, y)].push_back(location);
+	grid.bounds.Add(x, y);
+	grid.amount++;
+}
+
+void ItemKnowledge::Erase(const Vector2& location, eItemType type)
+{
+	Grid& grid = m_Grids[size_t(type)];
+	const int x = ToCell(location.x);
+	const int y = ToCell(location.y);
+	auto it = grid.cells.find(ToKey(x, y));
+	std::vector<Vector2>& locations = it->second;
+	*std::find(locations.begin(), locations.end(), location) = locations.back();
+	locations.pop_back();
+	grid.amount--;
+	if (!locations.empty())
+		return;
+
+	grid.cells.erase(it);
+	const GridBounds& bounds = grid.bounds;
+	if (x != bounds.minX && x != bounds.maxX && y != bounds.minY && y != bounds.maxY)
+		return;
+
+	// the cell was on the edge, the remaining ones may lie closer together
+	grid.bounds.Reset();
+	for (const auto& cell : grid.cells)
+		grid.bounds.Add(ToCellX(cell.first), ToCellY(cell.first));
+}
+
+bool ItemKnowledge::FindType(const Vector2& location, eItemType& type) const
+{
+	const uint64_t key = ToKey(ToCell(location.x), ToCell(location.y));
+	for (size_t i = 0; i < m_Grids.size(); i++)
+	{
+		auto it = m_Grids[i].cells.find(key);
+		if (it == m_Grids[i].cells.end())
+			continue;
+
+		if (std::find(it->second.begin(), it->second.end(), location) != it->second.end())
+		{
+			type = eItemType(i);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "stdafx.h"
+#include "Exam_HelperStructs.h"
+#include "GridSearch.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Every item location the brain knows, hashed into a uniform grid per item type.
+// Locations are matched exactly, like the entity locations the interface reports.
+// Nearest queries only search the grid of their type, ring by ring around the position,
+// and stop as soon as no farther ring can hold anything closer.
+class ItemKnowledge
+{
+public:
+	// items seen in the FOV but not grabbed yet, their type is not known
+	static constexpr eItemType Unknown = eItemType::RANDOM_DROP;
+
+	explicit ItemKnowledge(float cellSize = 16.f);
+
+	// false when the location is already known, with any type
+	bool Insert(const Elite::Vector2& location, eItemType type);
+	// inserts or changes the type of a known location
+	void Set(const Elite::Vector2& location, eItemType type);
+	bool Remove(const Elite::Vector2& location);
+	bool Contains(const Elite::Vector2& location) const;
+	bool Find(const Elite::Vector2& location, eItemType& type) const;
+	// false when no item of that type is known
+	bool GetNearest(const Elite::Vector2& pos, eItemType type, Elite::Vector2& nearest) const;
+	size_t GetAmount(eItemType type) const;
+
+	// func(location, type) for every item, in no particular order
+	template<typename TFunc>
+	void ForEach(TFunc func) const
+	{
+		for (size_t type = 0; type < m_Grids.size(); type++)
+		{
+			for (const auto& cell : m_Grids[type].cells)
+			{
+				for (const Elite::Vector2& location : cell.second)
+					func(location, eItemType(type));
+			}
+		}
+	};
+
+private:
+	struct Grid
+	{
+		std::unordered_map<uint64_t, std::vector<Elite::Vector2>> cells;
+		// recomputed when a cell on the edge empties
+		GridBounds bounds;
+		size_t amount;
+	};
+
+	const float m_CellSize;
+	// indexed by type
+	std::vector<Grid> m_Grids;
+
+	int ToCell(float coordinate) const { return int(floorf(coordinate / m_CellSize)); };
+	static uint64_t ToKey(int x, int y) { return ToGridKey(x, y); };
+	static int ToCellX(uint64_t key) { return int(uint32_t(key >> 32)); };
+	static int ToCellY(uint64_t key) { return int(uint32_t(key)); };
+	void Add(const Elite::Vector2& location, eItemType type);
+	// removes the location from the grid of its type
+	void Erase(const Elite::Vector2& location, eItemType type);
+	// there are few types, a lookup checks the grid of each one
+	bool FindType(const Elite::Vector2& location, eItemType& type) const;
+};
@@ -0,0 +1,61 @@
+#include "LinearMemoryAllocator.h"
+#include <cassert>
+#include <new>
+
+LinearMemoryAllocator::LinearMemoryAllocator(size_t nbBytes, eBackingStore store)
+	: m_Capacity{ nbBytes }
+	, m_Store{ store }
+	, m_Offset{ 0 }
+	, m_LastOffset{ 0 }
+{
+	m_pBuffer = reinterpret_cast<char*>(AcquireBackingStore(m_Capacity, m_Store));
+	if (!m_pBuffer)
+		throw std::bad_alloc{};
+}
+
+LinearMemoryAllocator::~LinearMemoryAllocator()
+{
+	ReleaseBackingStore(m_pBuffer, m_Capacity, m_Store);
+}
+
+void* LinearMemoryAllocator::Acquire(size_t nbBytes)
+{
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+void* LinearMemoryAllocator::TryAcquire(size_t nbBytes) noexcept
+{
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce(nbBytes);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
+}
+
+void* LinearMemoryAllocator::AcquireOnce(size_t nbBytes)
+{
+	const size_t offset = (m_Offset + Alignment - 1) & ~size_t(Alignment - 1);
+	if (offset > m_Capacity || m_Capacity - offset < nbBytes)
+		return nullptr;
+
+	m_LastOffset = offset;
+	m_Offset = offset + nbBytes;
+	return m_pBuffer + offset;
+}
+
+void LinearMemoryAllocator::Release(void* pStart)
+{
+	if (pStart == m_pBuffer + m_LastOffset && m_LastOffset < m_Offset)
+		m_Offset = m_LastOffset;
+}
+
+void LinearMemoryAllocator::RewindTo(Marker marker)
+{
+	assert(marker <= m_Offset && "marker is newer than the current top");
+	m_Offset = marker;
+	m_LastOffset = marker;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "BackingStore.h"
+#include "OutOfMemoryHandler.h"
+#include <cstddef>
+
+// Bump pointer arena for scratch memory. Nothing is freed one by one (except the latest
+// acquisition), instead everything acquired after a marker is dropped in O(1) by rewinding.
+class LinearMemoryAllocator : public MemoryAllocator
+{
+public:
+	using Marker = size_t;
+
+	// rewinds to the marker taken on construction when it goes out of scope
+	class Scope
+	{
+	public:
+		Scope(LinearMemoryAllocator& allocator) : m_Allocator{ allocator }, m_Marker{ allocator.GetMarker() } {};
+		~Scope() { m_Allocator.RewindTo(m_Marker); };
+
+		Scope(const Scope& other) = delete;
+		Scope(Scope&& other) = delete;
+		Scope& operator=(const Scope& other) = delete;
+		Scope& operator=(Scope&& other) = delete;
+
+	private:
+		LinearMemoryAllocator& m_Allocator;
+		const Marker m_Marker;
+	};
+
+	LinearMemoryAllocator(size_t nbBytes, eBackingStore store = eBackingStore::Heap);
+	virtual ~LinearMemoryAllocator();
+	virtual void* Acquire(size_t nbBytes = 0) override;
+	// like Acquire, but returns nullptr once the out of memory handler gives up,
+	// a handler can only make room by rewinding
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	// only the latest acquisition is given back, anything else waits for a rewind
+	virtual void Release(void* pStart) override;
+	Marker GetMarker() const { return m_Offset; };
+	void RewindTo(Marker marker);
+	void Reset() { m_Offset = 0; m_LastOffset = 0; };
+	char* GetHead() const { return m_pBuffer; };
+	size_t GetCapacity() const { return m_Capacity; };
+	size_t GetUsedBytes() const { return m_Offset; };
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
+
+	LinearMemoryAllocator(const LinearMemoryAllocator& other) = delete;
+	LinearMemoryAllocator(LinearMemoryAllocator&& other) = delete;
+	LinearMemoryAllocator& operator=(const LinearMemoryAllocator& other) = delete;
+	LinearMemoryAllocator& operator=(LinearMemoryAllocator&& other) = delete;
+
+private:
+	enum { Alignment = alignof(std::max_align_t) };
+
+	char* m_pBuffer;
+	const size_t m_Capacity;
+	const eBackingStore m_Store;
+	size_t m_Offset;
+	size_t m_LastOffset;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	// a single bump without the handler, nullptr when the rest of the buffer is too small
+	void* AcquireOnce(size_t nbBytes);
+};
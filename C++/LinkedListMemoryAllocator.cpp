@@ -1,151 +1,894 @@
 #include "LinkedListMemoryAllocator.h"
+#include "BitScan.h"
 #include <iostream>
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
 
-LinkedListMemoryAllocator::LinkedListMemoryAllocator(size_t nbBytes)
-	: m_BlockAmount{ size_t((nbBytes + 2 * sizeof(SingleLinkBlock) - 1) / sizeof(SingleLinkBlock)) }
+template<size_t BlockSize, typename THeader>
+BasicLinkedListMemoryAllocator<BlockSize, THeader>::BasicLinkedListMemoryAllocator(size_t nbBytes, eFreeListMode mode, ePlacement placement, eBackingStore store)
+	: m_BlockAmount{ size_t((nbBytes + 2 * sizeof(Block) - 1) / sizeof(Block)) }
+	, m_Mode{ mode }
+	, m_Placement{ placement }
+	, m_TreeRoot{ 0 }
+	, m_Store{ store }
+	, m_DiscardBytes{ size_t(256) << 10 }
+	, m_ClassBitmap{ 0 }
+	, m_ClassHeads{}
 {
+	if (IsIndexed() && m_BlockAmount > std::numeric_limits<uint32_t>::max())
+		throw std::length_error("arena too big for segregated mode or best fit");
+	if (m_BlockAmount > MaxCount)
+		throw std::length_error("arena too big for the block count");
+
 	//std::cout << "Single | Blocks: " << m_BlockAmount << " Bytes: " << nbBytes << std::endl;
-	m_pHead = reinterpret_cast<SingleLinkBlock*>(malloc(m_BlockAmount * SingleLinkBlock::size));
+	m_pHead = reinterpret_cast<Block*>(AcquireBackingStore(m_BlockAmount * Block::size, m_Store));
+	if (!m_pHead)
+		throw std::bad_alloc{};
+
+	m_pHead->isFree = false;
+	m_pHead->isPreviousFree = false;
 	m_pHead->count = 0;
-	m_pHead->pNext = m_pHead + 1;
-	m_pHead->pNext->pNext = nullptr;
-	m_pHead->pNext->count = m_BlockAmount - 1;
+	m_pRover = m_pHead;
+
+	Block* pFirst = m_pHead + 1;
+	pFirst->isPreviousFree = false;
+	SetFree(pFirst, m_BlockAmount - 1);
+	if (IsIndexed())
+	{
+		PushFree(pFirst);
+	}
+	else
+	{
+		m_pHead->pNext = pFirst;
+		pFirst->pNext = nullptr;
+		m_Stats.AddFreeRun(pFirst->count);
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+BasicLinkedListMemoryAllocator<BlockSize, THeader>::~BasicLinkedListMemoryAllocator()
+{
+	ReleaseBackingStore(reinterpret_cast<void*>(m_pHead), m_BlockAmount * Block::size, m_Store);
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::Acquire(size_t nbBytes)
+{
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::Acquire(size_t nbBytes, size_t alignment)
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		throw std::invalid_argument("alignment has to be a power of two");
+
+	void* pData = TryAcquire(nbBytes, alignment);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::TryAcquire(size_t nbBytes) noexcept
+{
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce(nbBytes);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
 }
 
-LinkedListMemoryAllocator::~LinkedListMemoryAllocator()
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::TryAcquire(size_t nbBytes, size_t alignment) noexcept
 {
-	free(reinterpret_cast<void*>(m_pHead));
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		return nullptr;
+	if (alignment <= sizeof(Header))
+		return TryAcquire(nbBytes);
+
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireAlignedOnce(nbBytes, alignment);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
 }
 
-void* LinkedListMemoryAllocator::Acquire(size_t nbBytes)
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::AcquireOnce(size_t nbBytes)
 {
 	size_t blockAmount = CalculateBlockAmount(nbBytes);
-	bool notEnoughSpaceLeft = true;
-	auto pPrevious = m_pHead;
-	auto pNext = m_pHead->pNext;
-	while (pNext != nullptr)
+	if (IsIndexed())
 	{
-		if (pNext->count >= blockAmount)
+		Block* pBlock = FindIndexed(blockAmount);
+		if (!pBlock)
+			return nullptr;
+
+		UnlinkFree(pBlock);
+		if (pBlock->count > blockAmount)
 		{
-			notEnoughSpaceLeft = false;
-			break;
+			Block* pRest = pBlock + blockAmount;
+			SetFree(pRest, pBlock->count - blockAmount);
+			PushFree(pRest);
 		}
-		pPrevious = pNext;
-		pNext = pNext->pNext;
+		SetReserved(pBlock, blockAmount);
+		m_Stats.AddUsed(blockAmount);
+		return pBlock->data;
 	}
 
-	if (notEnoughSpaceLeft)
-	{
-		throw std::exception("out of memory");
-		//return nullptr;
-	}
+	Block* pPrevious;
+	Block* pNext = FindAddressOrdered(blockAmount, pPrevious);
+	if (pNext == nullptr)
+		return nullptr;
 
+	m_Stats.RemoveFreeRun(pNext->count);
 	if (pNext->count > blockAmount)
 	{
 		// if free block > needed, setup new header
 
-		SingleLinkBlock* pNextFree = pNext + blockAmount;
-		pNextFree->count = pNext->count - blockAmount;
+		Block* pNextFree = pNext + blockAmount;
+		SetFree(pNextFree, pNext->count - blockAmount);
 		pNextFree->pNext = pNext->pNext;
 		pPrevious->pNext = pNextFree;
+		m_Stats.AddFreeRun(pNextFree->count);
 	}
 	else
 	{
 		// if free block == needed, simply copy next pointer
 		pPrevious->pNext = pNext->pNext;
 	}
-	pNext->count = blockAmount;
+	SetReserved(pNext, blockAmount);
+	m_Stats.AddUsed(blockAmount);
+	if (m_Placement == ePlacement::NextFit)
+		m_pRover = pPrevious;
 	return pNext->data;
 }
 
-void LinkedListMemoryAllocator::Release(void* pStart)
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::AcquireAlignedOnce(size_t nbBytes, size_t alignment)
+{
+	Block* pPrevious = m_pHead;
+	Block* pRun = nullptr;
+	Block* pBlock = nullptr;
+	char* pData = nullptr;
+	size_t blockAmount = 0;
+	if (IsIndexed())
+	{
+		// any run of this size fits, no matter where it starts
+		pRun = FindIndexed(CalculateBlockAmount(nbBytes + alignment + sizeof(Header)));
+		if (pRun)
+			blockAmount = FitAligned(pRun, nbBytes, alignment, pBlock, pData);
+	}
+	else
+	{
+		for (pRun = m_pHead->pNext; pRun != nullptr; pPrevious = pRun, pRun = pRun->pNext)
+		{
+			blockAmount = FitAligned(pRun, nbBytes, alignment, pBlock, pData);
+			if (blockAmount)
+				break;
+		}
+	}
+
+	if (!blockAmount)
+		return nullptr;
+
+	// the run is split into a free front, the acquired blocks and a free rest
+	const size_t frontCount = size_t(pBlock - pRun);
+	const size_t restCount = pRun->count - frontCount - blockAmount;
+	Block* pRest = pBlock + blockAmount;
+	Block* pNextFree = pRun->pNext;
+	if (IsIndexed())
+		UnlinkFree(pRun);
+
+	if (frontCount)
+		SetFree(pRun, frontCount);
+	SetReserved(pBlock, blockAmount);
+	if (restCount)
+		SetFree(pRest, restCount);
+
+	if (IsIndexed())
+	{
+		if (frontCount)
+			PushFree(pRun);
+		if (restCount)
+			PushFree(pRest);
+	}
+	else
+	{
+		if (restCount)
+		{
+			pRest->pNext = pNextFree;
+			pNextFree = pRest;
+		}
+		if (frontCount)
+			pRun->pNext = pNextFree;
+		else
+			pPrevious->pNext = pNextFree;
+		if (!frontCount && m_pRover == pRun)
+			m_pRover = pPrevious;
+		m_Stats.RemoveFreeRun(frontCount + blockAmount + restCount);
+		if (frontCount)
+			m_Stats.AddFreeRun(frontCount);
+		if (restCount)
+			m_Stats.AddFreeRun(restCount);
+	}
+	m_Stats.AddUsed(blockAmount);
+
+	if (pData != pBlock->data)
+	{
+		// marks the header in front of the data, the real one sits in the block below
+		Header* pMarker = reinterpret_cast<Header*>(pData) - 1;
+		pMarker->isFree = true;
+		pMarker->isPreviousFree = false;
+		pMarker->count = 0;
+	}
+	return pData;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::Release(void* pStart)
 {
 	// Check if pStart is part of buffer
 	if (pStart == nullptr || pStart < m_pHead + 1 || m_pHead + m_BlockAmount <= pStart)
 	{
 		return;
 	}
-	SingleLinkBlock* pBlock = reinterpret_cast<SingleLinkBlock*>(reinterpret_cast<SingleLinkHeader*>(pStart) - 1);
-	auto pPrevious = m_pHead;
-	auto pNext = m_pHead->pNext;
-	while (pNext != nullptr && pNext < pBlock)
+	Block* pBlock = GetBlock(pStart);
+	m_Stats.RemoveUsed(pBlock->count);
+	if (IsIndexed())
 	{
-		pPrevious = pNext;
-		pNext = pNext->pNext;
+		ReleaseIndexed(pBlock);
+		return;
 	}
+	Block* pPrevious = m_pHead;
+	ReleaseAddressOrdered(pBlock, pPrevious);
+}
 
-	// pBlock is after last empty
-	if (pNext == nullptr)
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::AcquireBatch(size_t nbBytes, size_t amount, void** ppOut)
+{
+	const size_t blockAmount = CalculateBlockAmount(nbBytes);
+	size_t acquiredAmount = 0;
+	if (IsIndexed())
 	{
-		if (pPrevious + pPrevious->count == pBlock)
+		while (acquiredAmount < amount)
 		{
-			pPrevious->count += pBlock->count;
+			// one run for the whole rest if there is one, else whatever fits at least one
+			size_t carveAmount = amount - acquiredAmount;
+			Block* pRun = carveAmount <= m_BlockAmount / blockAmount ? FindIndexed(carveAmount * blockAmount) : nullptr;
+			if (!pRun)
+				pRun = FindIndexed(blockAmount);
+			if (!pRun)
+				break;
+
+			UnlinkFree(pRun);
+			Block* pRest = CarveBatch(pRun, blockAmount, carveAmount, ppOut + acquiredAmount);
+			if (pRest)
+				PushFree(pRest);
+			acquiredAmount += carveAmount;
 		}
-		else // another block between last free and block
+	}
+	else
+	{
+		// a single pass over the list, every run is used up before moving on
+		Block* pPrevious = m_pHead;
+		while (acquiredAmount < amount && pPrevious->pNext != nullptr)
 		{
-			pPrevious->pNext = pBlock;
-			pBlock->pNext = nullptr;
+			Block* pRun = pPrevious->pNext;
+			if (pRun->count < blockAmount)
+			{
+				pPrevious = pRun;
+				continue;
+			}
+
+			Block* pNextFree = pRun->pNext;
+			m_Stats.RemoveFreeRun(pRun->count);
+			size_t carveAmount = amount - acquiredAmount;
+			Block* pRest = CarveBatch(pRun, blockAmount, carveAmount, ppOut + acquiredAmount);
+			if (pRest)
+			{
+				pRest->pNext = pNextFree;
+				pPrevious->pNext = pRest;
+				m_Stats.AddFreeRun(pRest->count);
+			}
+			else
+				pPrevious->pNext = pNextFree;
+
+			if (m_pRover == pRun)
+				m_pRover = pRest ? pRest : pPrevious;
+			acquiredAmount += carveAmount;
 		}
+	}
+
+	if (acquiredAmount < amount)
+	{
+		ReleaseBatch(ppOut, acquiredAmount);
+		throw std::bad_alloc{};
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::ReleaseBatch(void** ppStarts, size_t amount)
+{
+	// in address order every walk carries on where the one before stopped
+	std::sort(ppStarts, ppStarts + amount, std::less<void*>());
+	Block* pPrevious = m_pHead;
+	for (size_t i = 0; i < amount; i++)
+	{
+		void* pStart = ppStarts[i];
+		if (pStart == nullptr || pStart < m_pHead + 1 || m_pHead + m_BlockAmount <= pStart)
+			continue;
+
+		Block* pBlock = GetBlock(pStart);
+		m_Stats.RemoveUsed(pBlock->count);
+		if (IsIndexed())
+			ReleaseIndexed(pBlock);
+		else
+			ReleaseAddressOrdered(pBlock, pPrevious);
+	}
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::ReleaseAddressOrdered(Block* pBlock, Block*& pPrevious)
+{
+	// block in front is empty, it is already in the list so no walk is needed
+	Block* pBehind = pBlock + pBlock->count;
+	const bool isBehindFree = pBehind < m_pHead + m_BlockAmount && pBehind->isFree;
+	const size_t behindCount = isBehindFree ? size_t(pBehind->count) : 0;
+	if (pBlock->isPreviousFree)
+	{
+		pPrevious = pBlock - (pBlock - 1)->count;
+		const size_t frontCount = pPrevious->count;
+		const size_t count = frontCount + pBlock->count + behindCount;
+		if (isBehindFree) // no other free run can be between the two neighbours
+		{
+			pPrevious->pNext = pBehind->pNext;
+			m_Stats.RemoveFreeRun(behindCount);
+			if (m_pRover == pBehind)
+				m_pRover = pPrevious;
+		}
+		m_Stats.ResizeFreeRun(frontCount, count);
+		SetFree(pPrevious, count);
+		DiscardMerged(pPrevious, count, frontCount, behindCount);
 		return;
 	}
 
-	// block behind is empty
-	if (pBlock + pBlock->count == pNext)
+	// the walk starts at pPrevious, which has to be in the list and in front of pBlock
+	auto pNext = pPrevious->pNext;
+	while (pNext != nullptr && pNext < pBlock)
+	{
+		pPrevious = pNext;
+		pNext = pNext->pNext;
+	}
+
+	const size_t count = pBlock->count + behindCount;
+	if (isBehindFree) // block behind is empty
 	{
-		pBlock->count += pNext->count;
 		pBlock->pNext = pNext->pNext;
+		m_Stats.RemoveFreeRun(behindCount);
+		if (m_pRover == pNext)
+			m_pRover = pBlock;
 	}
 	else // next free block is somewhere else
-	{
 		pBlock->pNext = pNext;
+	pPrevious->pNext = pBlock;
+	m_Stats.AddFreeRun(count);
+	SetFree(pBlock, count);
+	DiscardMerged(pBlock, count, 0, behindCount);
+	pPrevious = pBlock;
+}
+
+template<size_t BlockSize, typename THeader>
+void* BasicLinkedListMemoryAllocator<BlockSize, THeader>::Reallocate(void* pStart, size_t nbBytes)
+{
+	if (pStart == nullptr)
+		return Acquire(nbBytes);
+
+	Block* pBlock = GetBlock(pStart);
+	const size_t blockAmount = GetNeededBlocks(pBlock, pStart, nbBytes);
+	if (blockAmount <= pBlock->count)
+	{
+		ShrinkInPlace(pBlock, blockAmount);
+		return pStart;
 	}
+	if (TryExpandInPlace(pStart, nbBytes))
+		return pStart;
 
-	if (pPrevious + pPrevious->count == pBlock)
+	const size_t oldBytes = size_t(reinterpret_cast<char*>(pBlock + pBlock->count) - static_cast<char*>(pStart));
+	void* pData = Acquire(nbBytes);
+	memcpy(pData, pStart, oldBytes);
+	Release(pStart);
+	return pData;
+}
+
+template<size_t BlockSize, typename THeader>
+bool BasicLinkedListMemoryAllocator<BlockSize, THeader>::TryExpandInPlace(void* pStart, size_t nbBytes)
+{
+	if (pStart == nullptr || pStart < m_pHead + 1 || m_pHead + m_BlockAmount <= pStart)
+		return false;
+
+	Block* pBlock = GetBlock(pStart);
+	const size_t blockAmount = GetNeededBlocks(pBlock, pStart, nbBytes);
+	if (blockAmount <= pBlock->count)
+		return true;
+
+	Block* pBehind = pBlock + pBlock->count;
+	if (pBehind >= m_pHead + m_BlockAmount || !pBehind->isFree || size_t(pBlock->count) + pBehind->count < blockAmount)
+		return false;
+
+	const size_t oldCount = pBlock->count;
+	const size_t restCount = oldCount + pBehind->count - blockAmount;
+	Block* pRest = pBlock + blockAmount;
+	if (IsIndexed())
 	{
-		pPrevious->count += pBlock->count;
-		pPrevious->pNext = pBlock->pNext;
+		UnlinkFree(pBehind);
+		SetReserved(pBlock, blockAmount);
+		if (restCount)
+		{
+			SetFree(pRest, restCount);
+			PushFree(pRest);
+		}
+		m_Stats.AddUsed(blockAmount - oldCount);
+		return true;
 	}
+
+	// the run in front is the previous list entry if it is free, else it has to be searched
+	Block* pPrevious = m_pHead;
+	if (pBlock->isPreviousFree)
+		pPrevious = pBlock - (pBlock - 1)->count;
 	else
 	{
-		pPrevious->pNext = pBlock;
+		while (pPrevious->pNext != pBehind)
+			pPrevious = pPrevious->pNext;
+	}
+
+	Block* pNextFree = pBehind->pNext;
+	m_Stats.RemoveFreeRun(pBehind->count);
+	SetReserved(pBlock, blockAmount);
+	if (restCount)
+	{
+		SetFree(pRest, restCount);
+		pRest->pNext = pNextFree;
+		pPrevious->pNext = pRest;
+		m_Stats.AddFreeRun(restCount);
 	}
+	else
+		pPrevious->pNext = pNextFree;
+
+	if (m_pRover == pBehind)
+		m_pRover = restCount ? pRest : pPrevious;
+	m_Stats.AddUsed(blockAmount - oldCount);
+	return true;
 }
 
-std::string LinkedListMemoryAllocator::UsageToString(const char header, const  char begin, const  char unused, const  char used) const
+template<size_t BlockSize, typename THeader>
+MemoryStats BasicLinkedListMemoryAllocator<BlockSize, THeader>::GetStats() const
+{
+	return m_Stats.Snapshot(m_BlockAmount - 1, [this](uint32_t bucket, auto visit)
+	{
+		if (m_Mode == eFreeListMode::Segregated)
+		{
+			// the size classes are the histogram buckets
+			for (uint32_t i = m_ClassHeads[bucket]; i != 0; i = ToBlock(i)->links.next)
+				visit(size_t(ToBlock(i)->count));
+			return;
+		}
+		if (m_Placement == ePlacement::BestFit)
+		{
+			// the rightmost node of the tree is a largest run
+			uint32_t node = m_TreeRoot;
+			while (node != 0 && GetTreeLinks(node).right != 0)
+				node = GetTreeLinks(node).right;
+			if (node != 0)
+				visit(size_t(ToBlock(node)->count));
+			return;
+		}
+		for (const Block* pRun = m_pHead->pNext; pRun != nullptr; pRun = pRun->pNext)
+			visit(size_t(pRun->count));
+	});
+}
+
+template<size_t BlockSize, typename THeader>
+std::string BasicLinkedListMemoryAllocator<BlockSize, THeader>::UsageToString(const char header, const  char begin, const  char unused, const  char used) const
 {
 	if (!m_pHead)
 	{
 		return "LLMA | Head is nullptr";
 	}
 	std::string string{ header };
-	SingleLinkBlock* pCurrent = m_pHead->pNext;
+	Block* pCurrent = m_pHead + 1;
+	Block* pEnd = m_pHead + m_BlockAmount;
 
-	for (size_t i = 1; i < m_BlockAmount; i++)
+	// walk the blocks physically, indexed free runs are not address ordered
+	while (pCurrent < pEnd)
 	{
-		if (pCurrent && m_pHead + i == pCurrent)
+		if (pCurrent->isFree)
 		{
 			string += begin;
 			string += std::string(pCurrent->count - 1, unused);
-			i += pCurrent->count - 1;
-			pCurrent = pCurrent->pNext;
 		}
 		else
 		{
-			string += used;
+			string += std::string(pCurrent->count, used);
 		}
+		pCurrent = pCurrent + pCurrent->count;
 	}
 	return string;
 }
 
-void LinkedListMemoryAllocator::Visualize() const
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::Visualize() const
 {
 	std::cout << UsageToString() << std::endl;
 }
 
-bool LinkedListMemoryAllocator::CheckMemory(std::string expected, const char header, const char begin, const char unused, const char used) const
+template<size_t BlockSize, typename THeader>
+bool BasicLinkedListMemoryAllocator<BlockSize, THeader>::CheckMemory(std::string expected, const char header, const char begin, const char unused, const char used) const
 {
 	std::string result{ UsageToString(header, begin, unused, used) };
 	return expected == result;
 }
+
+
+template<size_t BlockSize, typename THeader>
+auto BasicLinkedListMemoryAllocator<BlockSize, THeader>::FindIndexed(size_t blockAmount) const -> Block*
+{
+	if (blockAmount > std::numeric_limits<uint32_t>::max())
+		return nullptr;
+
+	if (m_Mode != eFreeListMode::Segregated)
+	{
+		// smallest count that is big enough, the lowest address among equals
+		uint32_t best = 0;
+		uint32_t node = m_TreeRoot;
+		while (node != 0)
+		{
+			if (ToBlock(node)->count >= blockAmount)
+			{
+				best = node;
+				node = GetTreeLinks(node).left;
+			}
+			else
+				node = GetTreeLinks(node).right;
+		}
+		return best != 0 ? ToBlock(best) : nullptr;
+	}
+
+	// every run in a class at or above the rounded up class is big enough
+	const uint32_t idx = FindLastSet(blockAmount);
+	const uint32_t fittingIdx = idx + ((size_t(1) << idx) < blockAmount ? 1 : 0);
+	const uint32_t fittingClasses = fittingIdx < ClassAmount ? m_ClassBitmap & (~uint32_t(0) << fittingIdx) : 0;
+	if (fittingClasses)
+		return ToBlock(m_ClassHeads[FindFirstSet(fittingClasses)]);
+
+	// runs of the exact class might still be big enough
+	for (uint32_t i = m_ClassHeads[idx]; i != 0; i = ToBlock(i)->links.next)
+	{
+		if (ToBlock(i)->count >= blockAmount)
+			return ToBlock(i);
+	}
+	return nullptr;
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicLinkedListMemoryAllocator<BlockSize, THeader>::FindAddressOrdered(size_t blockAmount, Block*& pPrevious) const -> Block*
+{
+	Block* pFit = nullptr;
+	Block* pFitPrevious = m_pHead;
+	// next fit starts behind the rover and wraps around once, up to and including the rover
+	Block* pStart = m_Placement == ePlacement::NextFit ? m_pRover : m_pHead;
+	bool isWrapped = pStart == m_pHead;
+	Block* pCurrentPrevious = pStart;
+	Block* pCurrent = pStart->pNext;
+	while (true)
+	{
+		if (pCurrent == nullptr)
+		{
+			if (isWrapped)
+				break;
+			isWrapped = true;
+			pCurrentPrevious = m_pHead;
+			pCurrent = m_pHead->pNext;
+			continue;
+		}
+
+		if (pCurrent->count >= blockAmount)
+		{
+			pFit = pCurrent;
+			pFitPrevious = pCurrentPrevious;
+			break;
+		}
+		if (isWrapped && pCurrent == pStart)
+			break;
+
+		pCurrentPrevious = pCurrent;
+		pCurrent = pCurrent->pNext;
+	}
+	pPrevious = pFitPrevious;
+	return pFit;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::ReleaseIndexed(Block* pBlock)
+{
+	Block* pStart = pBlock;
+	size_t count = pBlock->count;
+	size_t frontCount = 0;
+	size_t behindCount = 0;
+
+	// block behind is empty
+	Block* pNext = pBlock + pBlock->count;
+	if (pNext < m_pHead + m_BlockAmount && pNext->isFree)
+	{
+		UnlinkFree(pNext);
+		behindCount = pNext->count;
+		count += behindCount;
+	}
+
+	// block in front is empty, its footer holds its size
+	if (pBlock->isPreviousFree)
+	{
+		pStart = pBlock - (pBlock - 1)->count;
+		UnlinkFree(pStart);
+		frontCount = pStart->count;
+		count += frontCount;
+	}
+
+	SetFree(pStart, count);
+	PushFree(pStart);
+	DiscardMerged(pStart, count, frontCount, behindCount);
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::SetFree(Block* pBlock, size_t count)
+{
+	pBlock->isFree = true;
+	pBlock->count = count;
+	(pBlock + count - 1)->count = count;
+
+	Block* pNext = pBlock + count;
+	if (pNext < m_pHead + m_BlockAmount)
+		pNext->isPreviousFree = true;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::SetReserved(Block* pBlock, size_t count)
+{
+	pBlock->isFree = false;
+	pBlock->count = count;
+
+	Block* pNext = pBlock + count;
+	if (pNext < m_pHead + m_BlockAmount)
+		pNext->isPreviousFree = false;
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::PushFree(Block* pBlock)
+{
+	if (m_Mode != eFreeListMode::Segregated)
+	{
+		m_TreeRoot = TreeInsert(m_TreeRoot, ToIndex(pBlock));
+		m_Stats.AddFreeRun(pBlock->count);
+		return;
+	}
+
+	const uint32_t idx = FindLastSet(pBlock->count);
+	const uint32_t blockIdx = ToIndex(pBlock);
+	pBlock->links.previous = 0;
+	pBlock->links.next = m_ClassHeads[idx];
+	if (m_ClassHeads[idx] != 0)
+		ToBlock(m_ClassHeads[idx])->links.previous = blockIdx;
+	m_ClassHeads[idx] = blockIdx;
+	m_ClassBitmap |= uint32_t(1) << idx;
+	m_Stats.AddFreeRun(pBlock->count);
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::UnlinkFree(Block* pBlock)
+{
+	if (m_Mode != eFreeListMode::Segregated)
+	{
+		m_TreeRoot = TreeRemove(m_TreeRoot, ToIndex(pBlock));
+		m_Stats.RemoveFreeRun(pBlock->count);
+		return;
+	}
+
+	const uint32_t idx = FindLastSet(pBlock->count);
+	if (pBlock->links.previous != 0)
+		ToBlock(pBlock->links.previous)->links.next = pBlock->links.next;
+	else
+		m_ClassHeads[idx] = pBlock->links.next;
+
+	if (pBlock->links.next != 0)
+		ToBlock(pBlock->links.next)->links.previous = pBlock->links.previous;
+
+	if (m_ClassHeads[idx] == 0)
+		m_ClassBitmap &= ~(uint32_t(1) << idx);
+	m_Stats.RemoveFreeRun(pBlock->count);
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::DiscardMerged(Block* pRun, size_t count, size_t frontCount, size_t behindCount) const
+{
+	if (m_Store == eBackingStore::Heap || count * sizeof(Block) < m_DiscardBytes)
+		return;
+
+	// the first block keeps the links, the last one the footer;
+	// neighbours that already were large got their pages discarded when they were freed
+	const size_t largeCount = std::max(m_DiscardBytes / sizeof(Block), size_t(2));
+	Block* pFrom = frontCount >= largeCount ? pRun + frontCount - 1 : pRun + 1;
+	Block* pTo = behindCount >= largeCount ? pRun + count - behindCount + 1 : pRun + count - 1;
+	if (pFrom < pTo)
+		DiscardPages(pFrom, (pTo - pFrom) * sizeof(Block), m_Store);
+}
+
+template<size_t BlockSize, typename THeader>
+size_t BasicLinkedListMemoryAllocator<BlockSize, THeader>::FitAligned(Block* pRun, size_t nbBytes, size_t alignment, Block*& pBlock, char*& pData) const
+{
+	uintptr_t data = reinterpret_cast<uintptr_t>(pRun->data);
+	pBlock = pRun;
+	if (data % alignment != 0)
+	{
+		// leave room for a marker header between the real header and the aligned data
+		data = (data + sizeof(Header) + alignment - 1) & ~uintptr_t(alignment - 1);
+		pBlock = m_pHead + (data - 2 * sizeof(Header) - reinterpret_cast<uintptr_t>(m_pHead)) / sizeof(Block);
+	}
+
+	const uintptr_t end = reinterpret_cast<uintptr_t>(pRun + pRun->count);
+	if (data >= end || nbBytes > end - data)
+		return 0;
+
+	pData = reinterpret_cast<char*>(data);
+	return (data + nbBytes - reinterpret_cast<uintptr_t>(pBlock) + sizeof(Block) - 1) / sizeof(Block);
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicLinkedListMemoryAllocator<BlockSize, THeader>::GetBlock(void* pStart) const -> Block*
+{
+	Header* pHeader = reinterpret_cast<Header*>(pStart) - 1;
+	if (!pHeader->isFree)
+		return reinterpret_cast<Block*>(pHeader);
+
+	// marker of an aligned acquisition
+	const uintptr_t header = reinterpret_cast<uintptr_t>(pStart) - 2 * sizeof(Header);
+	return m_pHead + (header - reinterpret_cast<uintptr_t>(m_pHead)) / sizeof(Block);
+}
+
+template<size_t BlockSize, typename THeader>
+size_t BasicLinkedListMemoryAllocator<BlockSize, THeader>::GetNeededBlocks(const Block* pBlock, const void* pStart, size_t nbBytes)
+{
+	// aligned acquisitions start further into their block
+	const size_t offset = size_t(static_cast<const char*>(pStart) - reinterpret_cast<const char*>(pBlock));
+	return (offset + nbBytes + sizeof(Block) - 1) / sizeof(Block);
+}
+
+template<size_t BlockSize, typename THeader>
+void BasicLinkedListMemoryAllocator<BlockSize, THeader>::ShrinkInPlace(Block* pBlock, size_t blockAmount)
+{
+	const size_t restCount = pBlock->count - blockAmount;
+	if (restCount == 0)
+		return;
+
+	// the tail becomes a block of its own and is released, so it merges like any other
+	SetReserved(pBlock, blockAmount);
+	Block* pRest = pBlock + blockAmount;
+	SetReserved(pRest, restCount);
+	Release(pRest->data);
+}
+
+template<size_t BlockSize, typename THeader>
+auto BasicLinkedListMemoryAllocator<BlockSize, THeader>::CarveBatch(Block* pRun, size_t blockAmount, size_t& amount, void** ppOut) -> Block*
+{
+	const size_t runCount = pRun->count;
+	amount = std::min(amount, runCount / blockAmount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		Block* pBlock = pRun + i * blockAmount;
+		SetReserved(pBlock, blockAmount);
+		ppOut[i] = pBlock->data;
+	}
+	m_Stats.AddUsed(amount * blockAmount);
+
+	const size_t restCount = runCount - amount * blockAmount;
+	if (restCount == 0)
+		return nullptr;
+
+	Block* pRest = pRun + amount * blockAmount;
+	SetFree(pRest, restCount);
+	return pRest;
+}
+
+template<size_t BlockSize, typename THeader>
+uint32_t BasicLinkedListMemoryAllocator<BlockSize, THeader>::GetTreePriority(uint32_t idx)
+{
+	// the index is random enough once mixed, so no priority has to be stored
+	uint32_t hash = idx;
+	hash ^= hash >> 16;
+	hash *= 0x7feb352du;
+	hash ^= hash >> 15;
+	hash *= 0x846ca68bu;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+template<size_t BlockSize, typename THeader>
+uint32_t BasicLinkedListMemoryAllocator<BlockSize, THeader>::TreeInsert(uint32_t root, uint32_t idx)
+{
+	if (root == 0)
+	{
+		GetTreeLinks(idx) = { 0, 0 };
+		return idx;
+	}
+
+	TreeLinks& rootLinks = GetTreeLinks(root);
+	if (IsTreeLess(idx, root))
+	{
+		rootLinks.left = TreeInsert(rootLinks.left, idx);
+		if (GetTreePriority(rootLinks.left) > GetTreePriority(root))
+		{
+			// rotate right
+			const uint32_t left = rootLinks.left;
+			rootLinks.left = GetTreeLinks(left).right;
+			GetTreeLinks(left).right = root;
+			return left;
+		}
+	}
+	else
+	{
+		rootLinks.right = TreeInsert(rootLinks.right, idx);
+		if (GetTreePriority(rootLinks.right) > GetTreePriority(root))
+		{
+			// rotate left
+			const uint32_t right = rootLinks.right;
+			rootLinks.right = GetTreeLinks(right).left;
+			GetTreeLinks(right).left = root;
+			return right;
+		}
+	}
+	return root;
+}
+
+template<size_t BlockSize, typename THeader>
+uint32_t BasicLinkedListMemoryAllocator<BlockSize, THeader>::TreeRemove(uint32_t root, uint32_t idx)
+{
+	if (root == idx)
+		return TreeMerge(GetTreeLinks(root).left, GetTreeLinks(root).right);
+
+	TreeLinks& rootLinks = GetTreeLinks(root);
+	if (IsTreeLess(idx, root))
+		rootLinks.left = TreeRemove(rootLinks.left, idx);
+	else
+		rootLinks.right = TreeRemove(rootLinks.right, idx);
+	return root;
+}
+
+template<size_t BlockSize, typename THeader>
+uint32_t BasicLinkedListMemoryAllocator<BlockSize, THeader>::TreeMerge(uint32_t left, uint32_t right)
+{
+	if (left == 0)
+		return right;
+	if (right == 0)
+		return left;
+
+	if (GetTreePriority(left) > GetTreePriority(right))
+	{
+		GetTreeLinks(left).right = TreeMerge(GetTreeLinks(left).right, right);
+		return left;
+	}
+	GetTreeLinks(right).left = TreeMerge(left, GetTreeLinks(right).left);
+	return right;
+}
+
+template class BasicLinkedListMemoryAllocator<SingleLinkBlock::size, SingleLinkHeader>;
+template class BasicLinkedListMemoryAllocator<32, BasicSingleLinkHeader<uint32_t>>;
+template class BasicLinkedListMemoryAllocator<64, SingleLinkHeader>;
@@ -1,25 +1,132 @@
 #pragma once
 #include "MemoryAllocator.h"
 #include "MemoryBlock.h"
+#include "BackingStore.h"
+#include "MemoryStats.h"
+#include "PlacementPolicy.h"
+#include "OutOfMemoryHandler.h"
 #include <string>
 
-class LinkedListMemoryAllocator : public MemoryAllocator
+enum class eFreeListMode
+{
+	// One address ordered list, first fit. A release merges into a free run right in front
+	// without a walk, but when that neighbour is in use the singly linked list is walked from
+	// its start to find where the run goes, so a release costs O(free runs in front of it).
+	// ReleaseBatch sorts its blocks to share one walk; DoubleLinkedListMemoryAllocator
+	// releases in constant time.
+	AddressOrdered,
+	Segregated,		// one list per power of two size class, found through a bitmap, always good fit
+};
+
+// THeader is a BasicSingleLinkHeader, its count type limits the arena to 2^(digits - 2) blocks;
+// member definitions live in the .cpp, only the instantiations listed there are available
+template<size_t BlockSize, typename THeader = SingleLinkHeader>
+class BasicLinkedListMemoryAllocator : public MemoryAllocator
 {
 public:
-	LinkedListMemoryAllocator(size_t nbBytes);
-	virtual ~LinkedListMemoryAllocator();
+	using Header = THeader;
+	using Block = BasicSingleLinkBlock<BlockSize, THeader>;
+	static_assert(sizeof(Block) == BlockSize, "block layout does not add up to the block size");
+	static_assert(sizeof(Header) % alignof(void*) == 0, "data has to start right behind the header");
+
+	// placement only applies to the address ordered mode, best fit keeps its runs in a tree ordered
+	// by size instead of the list, which limits the arena to 2^32 blocks; the segregated mode
+	// ignores it and always takes a run of the smallest class that surely fits
+	BasicLinkedListMemoryAllocator(size_t nbBytes, eFreeListMode mode = eFreeListMode::AddressOrdered, ePlacement placement = ePlacement::FirstFit, eBackingStore store = eBackingStore::Heap);
+	virtual ~BasicLinkedListMemoryAllocator();
 	virtual void* Acquire(size_t nbBytes = 0) override;
+	// alignment has to be a power of two, Release takes the aligned pointer as is
+	void* Acquire(size_t nbBytes, size_t alignment);
+	// like Acquire, but returns nullptr once the out of memory handler gives up (or for a bad alignment)
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	void* TryAcquire(size_t nbBytes, size_t alignment) noexcept;
 	virtual void Release(void* pStart) override;
-	SingleLinkBlock* GetHead() const { return m_pHead; };
+	// acquires amount blocks of nbBytes carved from as few runs as possible, all or nothing
+	void AcquireBatch(size_t nbBytes, size_t amount, void** ppOut);
+	// sorts ppStarts by address
+	void ReleaseBatch(void** ppStarts, size_t amount);
+	// grows or shrinks in place when possible, otherwise acquires, copies and releases;
+	// the old block stays valid when that throws, a moved block only keeps the default alignment
+	void* Reallocate(void* pStart, size_t nbBytes);
+	// takes blocks from the free run behind, true when pStart now holds nbBytes
+	bool TryExpandInPlace(void* pStart, size_t nbBytes);
+	Block* GetHead() const { return m_pHead; };
 	size_t GetBlockAmount() const { return m_BlockAmount; };
+	eFreeListMode GetFreeListMode() const { return m_Mode; };
+	ePlacement GetPlacement() const { return m_Placement; };
+	eBackingStore GetBackingStore() const { return m_Store; };
+	MemoryStats GetStats() const;
+	// free runs of at least this size get their pages handed back to the OS, mapped stores only
+	void SetDiscardThreshold(size_t nbBytes) { m_DiscardBytes = nbBytes; };
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
 	std::string UsageToString(const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
 	void Visualize() const;
 	bool CheckMemory(std::string expected, const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
 	inline static size_t CalculateBlockAmount(const size_t nbBytes)
 	{
-		return size_t((nbBytes + sizeof(SingleLinkHeader) + sizeof(SingleLinkBlock) - 1) / sizeof(SingleLinkBlock));
+		return size_t((nbBytes + sizeof(Header) + sizeof(Block) - 1) / sizeof(Block));
 	};
 private:
-	SingleLinkBlock* m_pHead;
+	// largest run the count bitfield can hold
+	enum : size_t { MaxCount = std::numeric_limits<typename THeader::Count>::max() >> 2 };
+	// block counts are limited to 32 bit in segregated mode, so 32 classes cover every run
+	enum { ClassAmount = 32 };
+
+	Block* m_pHead;
 	size_t m_BlockAmount;
-};
\ No newline at end of file
+	eFreeListMode m_Mode;
+	ePlacement m_Placement;
+	// next fit continues behind this run (or the head), it is always part of the list
+	Block* m_pRover;
+	// best fit: treap of the free runs ordered by count, then address, the node lives in the
+	// data of the first block, which the list does not use in this mode
+	uint32_t m_TreeRoot;
+	eBackingStore m_Store;
+	size_t m_DiscardBytes;
+	uint32_t m_ClassBitmap;
+	uint32_t m_ClassHeads[ClassAmount];
+	MemoryStatsCounter m_Stats;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	struct TreeLinks
+	{
+		uint32_t left;
+		uint32_t right;
+	};
+
+	// segregated lists and the best fit tree index the runs, the address ordered list does not
+	bool IsIndexed() const { return m_Mode == eFreeListMode::Segregated || m_Placement == ePlacement::BestFit; };
+	Block* FindIndexed(size_t blockAmount) const;
+	Block* FindAddressOrdered(size_t blockAmount, Block*& pPrevious) const;
+	void ReleaseIndexed(Block* pBlock);
+	// pPrevious is where the list walk starts, afterwards it is the run pBlock ended up in
+	void ReleaseAddressOrdered(Block* pBlock, Block*& pPrevious);
+	// splits a run that is out of the list into up to amount blocks, returns the free rest or nullptr
+	Block* CarveBatch(Block* pRun, size_t blockAmount, size_t& amount, void** ppOut);
+	void PushFree(Block* pBlock);
+	void UnlinkFree(Block* pBlock);
+	// a single search without the handler, nullptr when nothing fits
+	void* AcquireOnce(size_t nbBytes);
+	void* AcquireAlignedOnce(size_t nbBytes, size_t alignment);
+	void SetFree(Block* pBlock, size_t count);
+	void SetReserved(Block* pBlock, size_t count);
+	void DiscardMerged(Block* pRun, size_t count, size_t frontCount, size_t behindCount) const;
+	size_t FitAligned(Block* pRun, size_t nbBytes, size_t alignment, Block*& pBlock, char*& pData) const;
+	Block* GetBlock(void* pStart) const;
+	static size_t GetNeededBlocks(const Block* pBlock, const void* pStart, size_t nbBytes);
+	void ShrinkInPlace(Block* pBlock, size_t blockAmount);
+	Block* ToBlock(uint32_t idx) const { return m_pHead + idx; };
+	uint32_t ToIndex(const Block* pBlock) const { return uint32_t(pBlock - m_pHead); };
+	TreeLinks& GetTreeLinks(uint32_t idx) const { return *reinterpret_cast<TreeLinks*>(ToBlock(idx)->data); };
+	bool IsTreeLess(uint32_t a, uint32_t b) const { return ToBlock(a)->count < ToBlock(b)->count || (ToBlock(a)->count == ToBlock(b)->count && a < b); };
+	static uint32_t GetTreePriority(uint32_t idx);
+	uint32_t TreeInsert(uint32_t root, uint32_t idx);
+	uint32_t TreeRemove(uint32_t root, uint32_t idx);
+	uint32_t TreeMerge(uint32_t left, uint32_t right);
+};
+
+using LinkedListMemoryAllocator = BasicLinkedListMemoryAllocator<SingleLinkBlock::size, SingleLinkHeader>;
+// 32 bit counts, up to 32 GiB, for arenas of small objects
+using SmallLinkedListMemoryAllocator = BasicLinkedListMemoryAllocator<32, BasicSingleLinkHeader<uint32_t>>;
+// one cache line per block, for arenas of large objects
+using CacheLineLinkedListMemoryAllocator = BasicLinkedListMemoryAllocator<64, SingleLinkHeader>;
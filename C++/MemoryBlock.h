@@ -1,46 +1,110 @@
 #pragma once
 #include <cstdlib>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 
-struct SingleLinkHeader
+// free runs repeat their count in the header slot of their last block (footer),
+// so the block behind a free run can find the run's start through isPreviousFree.
+// headers are padded to pointer alignment, the data of a block starts right behind its header
+template<typename TCount>
+struct alignas(void*) BasicSingleLinkHeader
 {
-	size_t count;
+	static_assert(std::is_unsigned<TCount>::value, "block counts have to be unsigned");
+	using Count = TCount;
+	TCount isFree : 1;
+	TCount isPreviousFree : 1;
+	TCount count : std::numeric_limits<TCount>::digits - 2;
 };
 
-struct SingleLinkBlock : public SingleLinkHeader
+template<size_t Size, typename THeader>
+struct BasicSingleLinkBlock : public THeader
 {
-	const static int size = 16;
+	static_assert(Size % alignof(void*) == 0, "block size has to be a multiple of the pointer alignment");
+	static_assert(Size >= sizeof(THeader) + sizeof(void*), "block too small for its header and a free list link");
+	enum : size_t { size = Size };
+	// segregated free lists link by block index relative to the head, 0 is the end of a list
+	struct Links
+	{
+		uint32_t next;
+		uint32_t previous;
+	};
 	union
 	{
-		SingleLinkBlock* pNext;
-		char data[size - sizeof(SingleLinkHeader)];
+		BasicSingleLinkBlock* pNext;
+		Links links;
+		char data[Size - sizeof(THeader)];
 	};
 };
 
+using SingleLinkHeader = BasicSingleLinkHeader<size_t>;
+using SingleLinkBlock = BasicSingleLinkBlock<16, SingleLinkHeader>;
+
+// relocatable blocks name their handle so compaction can update it, free runs have handle 0;
+// counts are 32 bit, handles are looked up in a table and not in the block
+struct alignas(void*) RelocatableHeader
+{
+	uint32_t handle;
+	uint32_t count;
+};
+
+using RelocatableBlock = BasicSingleLinkBlock<16, RelocatableHeader>;
+
 enum class Status : unsigned { free, reserved };
 
-struct DoubleLinkHeader
+// like SingleLinkHeader, free runs keep their count in a footer for previousStatus
+template<typename TCount>
+struct alignas(void*) BasicDoubleLinkHeader
 {
+	static_assert(std::is_unsigned<TCount>::value, "block counts have to be unsigned");
+	using Count = TCount;
 	Status status : 1;
-	size_t count : std::numeric_limits<size_t>::digits - 1;
+	Status previousStatus : 1;
+	TCount count : std::numeric_limits<TCount>::digits - 2;
+};
+
+template<size_t Size, typename THeader>
+struct BasicDoubleLinkBlock : public THeader
+{
+	static_assert(Size % alignof(void*) == 0, "block size has to be a multiple of the pointer alignment");
+	// best fit keeps a second pair of pointers in the data of the second block of a run
+	static_assert(Size >= sizeof(THeader) + 2 * sizeof(void*), "block too small for its header and two links");
+	enum : size_t { size = Size };
+	struct Links
+	{
+		BasicDoubleLinkBlock* pNext;
+		BasicDoubleLinkBlock* pPrevious;
+	};
+	union
+	{
+		Links links;
+		char data[Size - sizeof(THeader)];
+	};
+};
+
+using DoubleLinkHeader = BasicDoubleLinkHeader<size_t>;
+// the smallest block that holds the header and both links, 24 bytes on 64 bit unless the compiler
+// does not pack status and count into one word (32 bytes with msvc)
+using DoubleLinkBlock = BasicDoubleLinkBlock<sizeof(DoubleLinkHeader) + 2 * sizeof(void*), DoubleLinkHeader>;
+
+struct TLSFHeader
+{
+	size_t isFree : 1;
+	size_t isPreviousFree : 1;
+	size_t count : std::numeric_limits<size_t>::digits - 2;
 };
 
-struct DoubleLinkBlock : public DoubleLinkHeader
+struct TLSFBlock : public TLSFHeader
 {
-#if not defined (_WIN64)
-	enum { size = 16 };
-#endif
-#if defined (_WIN64)
 	enum { size = 32 };
-#endif
 	struct Links
 	{
-		DoubleLinkBlock* pNext;
-		DoubleLinkBlock* pPrevious;
+		TLSFBlock* pNext;
+		TLSFBlock* pPrevious;
 	};
 	union
 	{
 		Links links;
-		char data[size - sizeof(DoubleLinkHeader)];
+		char data[size - sizeof(TLSFHeader)];
 	};
 };
\ No newline at end of file
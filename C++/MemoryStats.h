@@ -0,0 +1,124 @@
+#pragma once
+#include "BitScan.h"
+#include <cstddef>
+#include <limits>
+
+// occupancy of a block allocator, every amount is in blocks
+struct MemoryStats
+{
+	enum { HistogramSize = std::numeric_limits<size_t>::digits };
+
+	size_t blockAmount;		// without the head block
+	size_t usedBlocks;
+	size_t freeBlocks;
+	size_t freeRunAmount;
+	size_t largestFreeRun;
+	// bucket i counts the free runs of 2^i up to 2^(i+1) - 1 blocks
+	size_t freeRunHistogram[HistogramSize];
+
+	// 0 while all free memory is one run, towards 1 the more it is split into small runs
+	double GetExternalFragmentation() const
+	{
+		return freeBlocks ? 1.0 - double(largestFreeRun) / double(freeBlocks) : 0.0;
+	};
+};
+
+// Updated by the allocators whenever a run enters or leaves a free list, O(1) each. Every
+// bucket keeps its largest run and how many runs have that size; once the last of them
+// leaves while others stay, the largest is unknown until a snapshot asks the allocator for
+// the runs of that bucket, which only happens when it is the top bucket.
+class MemoryStatsCounter
+{
+public:
+	void AddFreeRun(size_t count)
+	{
+		const uint32_t idx = FindLastSet(count);
+		m_FreeBlocks += count;
+		m_FreeRunAmount++;
+		m_HistogramBitmap |= size_t(1) << idx;
+		if (m_FreeRunHistogram[idx]++ == 0)
+		{
+			m_BucketMax[idx] = count;
+			m_BucketMaxAmount[idx] = 1;
+		}
+		else if (m_BucketMaxAmount[idx] != 0)
+		{
+			if (count > m_BucketMax[idx])
+			{
+				m_BucketMax[idx] = count;
+				m_BucketMaxAmount[idx] = 1;
+			}
+			else if (count == m_BucketMax[idx])
+				m_BucketMaxAmount[idx]++;
+		}
+	};
+	void RemoveFreeRun(size_t count)
+	{
+		const uint32_t idx = FindLastSet(count);
+		m_FreeBlocks -= count;
+		m_FreeRunAmount--;
+		if (--m_FreeRunHistogram[idx] == 0)
+		{
+			m_HistogramBitmap &= ~(size_t(1) << idx);
+			m_BucketMaxAmount[idx] = 0;
+		}
+		else if (m_BucketMaxAmount[idx] != 0 && count == m_BucketMax[idx])
+			m_BucketMaxAmount[idx]--;
+	};
+	void ResizeFreeRun(size_t oldCount, size_t newCount)
+	{
+		RemoveFreeRun(oldCount);
+		AddFreeRun(newCount);
+	};
+	void AddUsed(size_t count) { m_UsedBlocks += count; };
+	void RemoveUsed(size_t count) { m_UsedBlocks -= count; };
+	size_t GetFreeBlocks() const { return m_FreeBlocks; };
+
+	// forEachRun(bucket, visit) calls visit(count) for every free run in that bucket, runs of
+	// other buckets are skipped; it is only called when the largest run of the top bucket left
+	template<typename TForEachRun>
+	MemoryStats Snapshot(size_t blockAmount, TForEachRun forEachRun) const
+	{
+		MemoryStats stats{};
+		stats.blockAmount = blockAmount;
+		stats.usedBlocks = m_UsedBlocks;
+		stats.freeBlocks = m_FreeBlocks;
+		stats.freeRunAmount = m_FreeRunAmount;
+		if (m_HistogramBitmap)
+		{
+			const uint32_t top = FindLastSet(m_HistogramBitmap);
+			if (m_BucketMaxAmount[top] == 0)
+			{
+				size_t& max = m_BucketMax[top];
+				size_t& maxAmount = m_BucketMaxAmount[top];
+				max = 0;
+				forEachRun(top, [top, &max, &maxAmount](size_t count)
+				{
+					if (FindLastSet(count) != top)
+						return;
+					if (count > max)
+					{
+						max = count;
+						maxAmount = 1;
+					}
+					else if (count == max)
+						maxAmount++;
+				});
+			}
+			stats.largestFreeRun = m_BucketMax[top];
+		}
+		for (size_t i = 0; i < MemoryStats::HistogramSize; i++)
+			stats.freeRunHistogram[i] = m_FreeRunHistogram[i];
+		return stats;
+	};
+
+private:
+	size_t m_UsedBlocks = 0;
+	size_t m_FreeBlocks = 0;
+	size_t m_FreeRunAmount = 0;
+	size_t m_HistogramBitmap = 0;
+	size_t m_FreeRunHistogram[MemoryStats::HistogramSize] = {};
+	// a bucket with runs but no amount has lost its largest run, a snapshot finds the new one
+	mutable size_t m_BucketMax[MemoryStats::HistogramSize] = {};
+	mutable size_t m_BucketMaxAmount[MemoryStats::HistogramSize] = {};
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Grows by adding arenas of TArena (LinkedListMemoryAllocator, DoubleLinkedListMemoryAllocator,
+// TLSFMemoryAllocator, ...; anything with a noexcept TryAcquire) on demand, each with its own head.
+// Release finds the owning arena through an address ordered range index. Arenas that become
+// empty are freed again as long as the reserved total stays above the high water mark.
+template<typename TArena>
+class MultiArenaMemoryAllocator : public MemoryAllocator
+{
+public:
+	// extra arguments are passed on to every arena after its size
+	template<typename... TArgs>
+	MultiArenaMemoryAllocator(size_t arenaBytes, size_t highWaterBytes, TArgs... args)
+		: m_ArenaBytes{ arenaBytes }
+		, m_HighWaterBytes{ highWaterBytes }
+		, m_ReservedBytes{ 0 }
+		, m_CurrentIdx{ 0 }
+		, m_CreateArena{ [args...](size_t nbBytes) { return std::make_unique<TArena>(nbBytes, args...); } }
+	{
+		AddArena(m_ArenaBytes);
+	}
+	virtual ~MultiArenaMemoryAllocator() = default;
+
+	virtual void* Acquire(size_t nbBytes = 0) override
+	{
+		void* pData = TryAcquire(nbBytes);
+		if (!pData)
+			throw std::bad_alloc{};
+		return pData;
+	}
+
+	// returns nullptr instead of throwing when no new arena can be created
+	void* TryAcquire(size_t nbBytes = 0) noexcept
+	{
+		// the arena that served last is the most likely to have room
+		void* pData = TryAcquireFrom(m_CurrentIdx, nbBytes);
+		for (size_t i = 0; !pData && i < m_Arenas.size(); i++)
+		{
+			if (i != m_CurrentIdx)
+				pData = TryAcquireFrom(i, nbBytes);
+		}
+		if (pData)
+			return pData;
+
+		// big enough for at least the request on its own
+		const size_t neededBytes = TArena::CalculateBlockAmount(nbBytes) * sizeof(Block);
+		size_t idx;
+		try
+		{
+			idx = AddArena(std::max(m_ArenaBytes, neededBytes));
+		}
+		catch (const std::exception&)
+		{
+			return nullptr;
+		}
+		return TryAcquireFrom(idx, nbBytes);
+	}
+
+	virtual void Release(void* pStart) override
+	{
+		if (pStart == nullptr)
+			return;
+
+		const size_t idx = FindArena(pStart);
+		if (idx == m_Arenas.size())
+			return;
+
+		Arena& arena = m_Arenas[idx];
+		arena.pAllocator->Release(pStart);
+		arena.liveAmount--;
+
+		if (arena.liveAmount == 0 && m_Arenas.size() > 1 && m_ReservedBytes > m_HighWaterBytes)
+			RemoveArena(idx);
+	}
+
+	size_t GetArenaAmount() const { return m_Arenas.size(); };
+	const TArena& GetArena(size_t idx) const { return *m_Arenas[idx].pAllocator; };
+	size_t GetReservedBytes() const { return m_ReservedBytes; };
+
+	MultiArenaMemoryAllocator(const MultiArenaMemoryAllocator& other) = delete;
+	MultiArenaMemoryAllocator(MultiArenaMemoryAllocator&& other) = delete;
+	MultiArenaMemoryAllocator& operator=(const MultiArenaMemoryAllocator& other) = delete;
+	MultiArenaMemoryAllocator& operator=(MultiArenaMemoryAllocator&& other) = delete;
+
+private:
+	using Block = std::remove_pointer_t<decltype(std::declval<const TArena&>().GetHead())>;
+
+	struct Arena
+	{
+		std::unique_ptr<TArena> pAllocator;
+		uintptr_t begin;
+		uintptr_t end;
+		size_t bytes;
+		size_t liveAmount;
+	};
+
+	const size_t m_ArenaBytes;
+	const size_t m_HighWaterBytes;
+	size_t m_ReservedBytes;
+	size_t m_CurrentIdx;
+	// sorted by begin address
+	std::vector<Arena> m_Arenas;
+	std::function<std::unique_ptr<TArena>(size_t)> m_CreateArena;
+
+	void* TryAcquireFrom(size_t idx, size_t nbBytes) noexcept
+	{
+		Arena& arena = m_Arenas[idx];
+		void* pData = arena.pAllocator->TryAcquire(nbBytes);
+		if (!pData)
+			return nullptr;
+		arena.liveAmount++;
+		m_CurrentIdx = idx;
+		return pData;
+	}
+
+	size_t AddArena(size_t nbBytes)
+	{
+		// room for the entry first, so the insert below cannot throw once the arena exists,
+		// if creating the arena throws the unique_ptr frees it and nothing is counted yet
+		if (m_Arenas.size() == m_Arenas.capacity())
+			m_Arenas.reserve(m_Arenas.size() * 2 + 1);
+		Arena arena{};
+		arena.pAllocator = m_CreateArena(nbBytes);
+		arena.begin = reinterpret_cast<uintptr_t>(arena.pAllocator->GetHead());
+		arena.end = reinterpret_cast<uintptr_t>(arena.pAllocator->GetHead() + arena.pAllocator->GetBlockAmount());
+		arena.bytes = arena.end - arena.begin;
+
+		auto it = std::upper_bound(m_Arenas.begin(), m_Arenas.end(), arena.begin, [](uintptr_t address, const Arena& other) { return address < other.begin; });
+		const size_t idx = size_t(it - m_Arenas.begin());
+		m_Arenas.insert(it, std::move(arena));
+		m_ReservedBytes += m_Arenas[idx].bytes;
+		if (m_CurrentIdx >= idx && m_Arenas.size() > 1)
+			m_CurrentIdx++;
+		return idx;
+	}
+
+	void RemoveArena(size_t idx)
+	{
+		m_ReservedBytes -= m_Arenas[idx].bytes;
+		m_Arenas.erase(m_Arenas.begin() + idx);
+		if (m_CurrentIdx > idx || m_CurrentIdx >= m_Arenas.size())
+			m_CurrentIdx = m_CurrentIdx ? m_CurrentIdx - 1 : 0;
+	}
+
+	size_t FindArena(const void* pStart) const
+	{
+		const uintptr_t address = reinterpret_cast<uintptr_t>(pStart);
+		auto it = std::upper_bound(m_Arenas.begin(), m_Arenas.end(), address, [](uintptr_t address, const Arena& other) { return address < other.begin; });
+		if (it == m_Arenas.begin())
+			return m_Arenas.size();
+
+		--it;
+		if (address >= it->end)
+			return m_Arenas.size();
+		return size_t(it - m_Arenas.begin());
+	}
+};
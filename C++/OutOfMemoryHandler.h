@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+// what an allocator does once its out of memory handler returns
+enum class eOutOfMemory
+{
+	Fail,	// give up, TryAcquire returns nullptr and Acquire throws
+	Retry,	// the handler made room (released, compacted, evicted, ...), search again
+};
+
+// called with the request and how often it was retried for it already. it runs inside
+// noexcept TryAcquire, so it must not throw. without a handler the allocator fails fast,
+// growing is what MultiArenaMemoryAllocator does before it gives up
+using OutOfMemoryHandler = std::function<eOutOfMemory(size_t nbBytes, size_t attempt)>;
+
+inline bool ShouldRetry(const OutOfMemoryHandler& handler, size_t nbBytes, size_t attempt) noexcept
+{
+	return handler && handler(nbBytes, attempt) == eOutOfMemory::Retry;
+}
@@ -0,0 +1,25 @@
+#include "stdafx.h"
+#include "Perception.h"
+#include <IExamInterface.h>
+
+void Perception::Capture(IExamInterface* pInterface)
+{
+	m_Agent = pInterface->Agent_GetInfo();
+	m_World = pInterface->World_GetInfo();
+	RefreshItemsPickedUp(pInterface);
+
+	m_Entities.clear();
+	EntityInfo ei = {};
+	for (int i = 0; pInterface->Fov_GetEntityByIndex(i, ei); ++i)
+		m_Entities.push_back(ei);
+
+	m_Houses.clear();
+	HouseInfo hi = {};
+	for (int i = 0; pInterface->Fov_GetHouseByIndex(i, hi); ++i)
+		m_Houses.push_back(hi);
+}
+
+void Perception::RefreshItemsPickedUp(IExamInterface* pInterface)
+{
+	m_ItemsPickedUp = int(pInterface->World_GetStats().NumItemsPickUp);
+}
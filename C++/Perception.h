@@ -0,0 +1,47 @@
+#pragma once
+#include "stdafx.h"
+#include "Exam_HelperStructs.h"
+#include <vector>
+
+class IExamInterface;
+
+// read only view of a contiguous range, valid until the owner refills it
+template<typename T>
+class Span
+{
+public:
+	Span(const T* pData, size_t size) : m_pData{ pData }, m_Size{ size } {};
+	const T* begin() const { return m_pData; };
+	const T* end() const { return m_pData + m_Size; };
+	const T& operator[](size_t idx) const { return m_pData[idx]; };
+	size_t size() const { return m_Size; };
+	bool empty() const { return m_Size == 0; };
+
+private:
+	const T* m_pData;
+	size_t m_Size;
+};
+
+// What the brain sees in one frame, queried from the interface once per Capture.
+// The FOV buffers are cleared and refilled but keep their capacity, so once they have
+// grown to the usual amount of entities and houses a frame does not allocate.
+class Perception
+{
+public:
+	void Capture(IExamInterface* pInterface);
+	const AgentInfo& GetAgent() const { return m_Agent; };
+	const WorldInfo& GetWorld() const { return m_World; };
+	// picked up items at the time of the capture or of the latest refresh
+	int GetItemsPickedUp() const { return m_ItemsPickedUp; };
+	// grabbing an item changes the count within the frame
+	void RefreshItemsPickedUp(IExamInterface* pInterface);
+	Span<EntityInfo> GetEntities() const { return { m_Entities.data(), m_Entities.size() }; };
+	Span<HouseInfo> GetHouses() const { return { m_Houses.data(), m_Houses.size() }; };
+
+private:
+	AgentInfo m_Agent{};
+	WorldInfo m_World{};
+	int m_ItemsPickedUp = 0;
+	std::vector<EntityInfo> m_Entities;
+	std::vector<HouseInfo> m_Houses;
+};
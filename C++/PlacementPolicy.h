@@ -0,0 +1,9 @@
+#pragma once
+
+// which free run a block allocator hands out when several are big enough
+enum class ePlacement
+{
+	FirstFit,	// the first run found from the start of the list
+	NextFit,	// the first run found from where the last search stopped, wrapping around
+	BestFit,	// the smallest run that is big enough
+};
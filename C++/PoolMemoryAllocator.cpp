@@ -0,0 +1,136 @@
+#include "PoolMemoryAllocator.h"
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "free stack links are stored in place of SingleLinkBlock::Links::next");
+
+PoolMemoryAllocator::PoolMemoryAllocator(size_t nbBytes, size_t cellBlocks)
+	: m_CellBlocks{ cellBlocks ? cellBlocks : 1 }
+	, m_Top{ 0 }
+{
+	// head block stays reserved like in the list allocators, cells follow it
+	const size_t cellAmount = (nbBytes + m_CellBlocks * sizeof(SingleLinkBlock) - 1) / (m_CellBlocks * sizeof(SingleLinkBlock));
+	if (cellAmount >= std::numeric_limits<uint32_t>::max())
+		throw std::length_error("pool has too many cells");
+
+	m_BlockAmount = 1 + cellAmount * m_CellBlocks;
+	m_pHead = reinterpret_cast<SingleLinkBlock*>(malloc(m_BlockAmount * sizeof(SingleLinkBlock)));
+	if (!m_pHead)
+		throw std::bad_alloc{};
+
+	m_pHead->isFree = false;
+	m_pHead->isPreviousFree = false;
+	m_pHead->count = 0;
+
+	// stack the cells so the lowest address is on top
+	for (size_t i = 0; i < cellAmount; i++)
+	{
+		SingleLinkBlock* pCell = ToCell(uint32_t(i));
+		pCell->isFree = true;
+		pCell->isPreviousFree = false;
+		pCell->count = m_CellBlocks;
+		NextOf(pCell).store(i + 1 < cellAmount ? uint32_t(i + 2) : 0, std::memory_order_relaxed);
+	}
+	m_Top.store(cellAmount ? 1 : 0, std::memory_order_release);
+}
+
+PoolMemoryAllocator::~PoolMemoryAllocator()
+{
+	free(reinterpret_cast<void*>(m_pHead));
+}
+
+void* PoolMemoryAllocator::Acquire(size_t nbBytes)
+{
+	if (nbBytes > GetCellBytes())
+		throw std::length_error("request exceeds pool cell size");
+
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+void* PoolMemoryAllocator::TryAcquire(size_t nbBytes) noexcept
+{
+	// no handler can make a cell bigger
+	if (nbBytes > GetCellBytes())
+		return nullptr;
+
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce();
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
+}
+
+void* PoolMemoryAllocator::AcquireOnce()
+{
+	uint64_t top = m_Top.load(std::memory_order_acquire);
+	while (true)
+	{
+		const uint32_t idx = uint32_t(top);
+		if (idx == 0)
+			return nullptr;
+
+		// next may already be stale when another thread won the race, the tag makes the exchange fail then
+		SingleLinkBlock* pCell = ToCell(idx - 1);
+		const uint32_t next = NextOf(pCell).load(std::memory_order_relaxed);
+		const uint64_t newTop = (((top >> 32) + 1) << 32) | next;
+		if (m_Top.compare_exchange_weak(top, newTop, std::memory_order_acquire, std::memory_order_acquire))
+		{
+			pCell->isFree = false;
+			return pCell->data;
+		}
+	}
+}
+
+void PoolMemoryAllocator::Release(void* pStart)
+{
+	// Check if pStart is part of buffer
+	if (pStart == nullptr || !Owns(pStart))
+		return;
+
+	SingleLinkBlock* pCell = reinterpret_cast<SingleLinkBlock*>(reinterpret_cast<SingleLinkHeader*>(pStart) - 1);
+	pCell->isFree = true;
+	const uint32_t idx = ToIndex(pCell) + 1;
+
+	uint64_t top = m_Top.load(std::memory_order_relaxed);
+	uint64_t newTop;
+	do
+	{
+		NextOf(pCell).store(uint32_t(top), std::memory_order_relaxed);
+		newTop = (((top >> 32) + 1) << 32) | idx;
+	} while (!m_Top.compare_exchange_weak(top, newTop, std::memory_order_release, std::memory_order_relaxed));
+}
+
+std::string PoolMemoryAllocator::UsageToString(const char header, const char begin, const char unused, const char used) const
+{
+	if (!m_pHead)
+		return "PMA | Head is nullptr";
+
+	std::string string{ header };
+	for (SingleLinkBlock* pCell = m_pHead + 1; pCell < m_pHead + m_BlockAmount; pCell += m_CellBlocks)
+	{
+		if (pCell->isFree)
+		{
+			string += begin;
+			string += std::string(m_CellBlocks - 1, unused);
+		}
+		else
+			string += std::string(m_CellBlocks, used);
+	}
+	return string;
+}
+
+void PoolMemoryAllocator::Visualize() const
+{
+	std::cout << UsageToString() << std::endl;
+}
+
+bool PoolMemoryAllocator::CheckMemory(std::string expected, const char header, const char begin, const char unused, const char used) const
+{
+	std::string result{ UsageToString(header, begin, unused, used) };
+	return expected == result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "MemoryBlock.h"
+#include "OutOfMemoryHandler.h"
+#include <atomic>
+#include <string>
+
+// Fixed size cells of one or more SingleLinkBlocks on a lock-free free stack,
+// Acquire and Release can be called from any number of threads at once.
+class PoolMemoryAllocator : public MemoryAllocator
+{
+public:
+	PoolMemoryAllocator(size_t nbBytes, size_t cellBlocks = 1);
+	virtual ~PoolMemoryAllocator();
+	virtual void* Acquire(size_t nbBytes = 0) override;
+	virtual void Release(void* pStart) override;
+	// returns nullptr instead of throwing when the cell is too small or the pool stays empty
+	// after the out of memory handler gave up
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	bool Owns(const void* pStart) const { return m_pHead + 1 <= pStart && pStart < m_pHead + m_BlockAmount; };
+	SingleLinkBlock* GetHead() const { return m_pHead; };
+	size_t GetBlockAmount() const { return m_BlockAmount; };
+	size_t GetCellBytes() const { return m_CellBlocks * sizeof(SingleLinkBlock) - sizeof(SingleLinkHeader); };
+	// not synchronized, set it before the pool is shared between threads
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
+	// not synchronized, only meaningful while no other thread uses the pool
+	std::string UsageToString(const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
+	void Visualize() const;
+	bool CheckMemory(std::string expected, const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
+
+	PoolMemoryAllocator(const PoolMemoryAllocator& other) = delete;
+	PoolMemoryAllocator(PoolMemoryAllocator&& other) = delete;
+	PoolMemoryAllocator& operator=(const PoolMemoryAllocator& other) = delete;
+	PoolMemoryAllocator& operator=(PoolMemoryAllocator&& other) = delete;
+
+private:
+	SingleLinkBlock* m_pHead;
+	size_t m_BlockAmount;
+	const size_t m_CellBlocks;
+	// low half: index + 1 of the top cell (0 when empty), high half: tag bumped on every change against ABA
+	std::atomic<uint64_t> m_Top;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	// a single pop without the handler, nullptr when the pool is empty
+	void* AcquireOnce();
+	SingleLinkBlock* ToCell(uint32_t idx) const { return m_pHead + 1 + idx * m_CellBlocks; };
+	uint32_t ToIndex(const SingleLinkBlock* pCell) const { return uint32_t((pCell - m_pHead - 1) / m_CellBlocks); };
+	static std::atomic<uint32_t>& NextOf(SingleLinkBlock* pCell) { return *reinterpret_cast<std::atomic<uint32_t>*>(&pCell->links.next); };
+};
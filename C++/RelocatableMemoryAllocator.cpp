@@ -0,0 +1,236 @@
+#include "RelocatableMemoryAllocator.h"
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <limits>
+#include <new>
+
+RelocatableMemoryAllocator::RelocatableMemoryAllocator(size_t nbBytes, eBackingStore store)
+	: m_BlockAmount{ size_t((nbBytes + 2 * sizeof(Block) - 1) / sizeof(Block)) }
+	, m_Store{ store }
+	, m_Handles(1)
+	, m_FreeHandle{ NullHandle }
+{
+	if (m_BlockAmount > std::numeric_limits<uint32_t>::max())
+		throw std::length_error("arena too big for the block count");
+
+	m_pHead = reinterpret_cast<Block*>(AcquireBackingStore(m_BlockAmount * sizeof(Block), m_Store));
+	if (!m_pHead)
+		throw std::bad_alloc{};
+
+	m_pHead->handle = NullHandle;
+	m_pHead->count = 0;
+
+	Block* pFirst = m_pHead + 1;
+	SetFree(pFirst, m_BlockAmount - 1);
+	pFirst->pNext = nullptr;
+	m_pHead->pNext = pFirst;
+	m_Stats.AddFreeRun(pFirst->count);
+}
+
+RelocatableMemoryAllocator::~RelocatableMemoryAllocator()
+{
+	ReleaseBackingStore(reinterpret_cast<void*>(m_pHead), m_BlockAmount * sizeof(Block), m_Store);
+}
+
+RelocatableMemoryAllocator::Handle RelocatableMemoryAllocator::Acquire(size_t nbBytes)
+{
+	const Handle handle = TryAcquire(nbBytes);
+	if (handle == NullHandle)
+		throw std::bad_alloc{};
+	return handle;
+}
+
+RelocatableMemoryAllocator::Handle RelocatableMemoryAllocator::TryAcquire(size_t nbBytes) noexcept
+{
+	if (!ReserveHandle())
+		return NullHandle;
+
+	const size_t blockAmount = CalculateBlockAmount(nbBytes);
+	for (size_t attempt = 0; ; attempt++)
+	{
+		Block* pBlock = AcquireOnce(blockAmount);
+		if (!pBlock && m_Stats.GetFreeBlocks() >= blockAmount)
+		{
+			// compacted, all free blocks are one run
+			Compact();
+			pBlock = AcquireOnce(blockAmount);
+		}
+
+		if (pBlock)
+		{
+			const Handle handle = m_FreeHandle;
+			m_FreeHandle = m_Handles[handle].nextFree;
+			m_Handles[handle].pBlock = pBlock;
+			pBlock->handle = handle;
+			return handle;
+		}
+		if (!ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return NullHandle;
+	}
+}
+
+void RelocatableMemoryAllocator::Release(Handle handle)
+{
+	if (handle == NullHandle || handle >= m_Handles.size())
+		return;
+
+	Block* pBlock = m_Handles[handle].pBlock;
+	m_Handles[handle].nextFree = m_FreeHandle;
+	m_FreeHandle = handle;
+	m_Stats.RemoveUsed(pBlock->count);
+
+	Block* pPrevious = m_pHead;
+	Block* pNext = m_pHead->pNext;
+	while (pNext != nullptr && pNext < pBlock)
+	{
+		pPrevious = pNext;
+		pNext = pNext->pNext;
+	}
+
+	size_t count = pBlock->count;
+	// block behind is empty
+	if (pNext == pBlock + count)
+	{
+		count += pNext->count;
+		m_Stats.RemoveFreeRun(pNext->count);
+		pNext = pNext->pNext;
+	}
+	// block in front is empty
+	if (pPrevious != m_pHead && pPrevious + pPrevious->count == pBlock)
+	{
+		m_Stats.RemoveFreeRun(pPrevious->count);
+		count += pPrevious->count;
+		pBlock = pPrevious;
+	}
+	else
+		pPrevious->pNext = pBlock;
+
+	SetFree(pBlock, count);
+	pBlock->pNext = pNext;
+	m_Stats.AddFreeRun(count);
+}
+
+size_t RelocatableMemoryAllocator::Compact(std::chrono::nanoseconds budget)
+{
+	using Clock = std::chrono::steady_clock;
+	const bool isBounded = budget != std::chrono::nanoseconds::max();
+	const Clock::time_point deadline = isBounded ? Clock::now() + budget : Clock::time_point{};
+	size_t movedAmount = 0;
+	while (SlideDown())
+	{
+		movedAmount++;
+		if (isBounded && Clock::now() >= deadline)
+			break;
+	}
+	return movedAmount;
+}
+
+bool RelocatableMemoryAllocator::IsCompact() const
+{
+	const Block* pFree = m_pHead->pNext;
+	return pFree == nullptr || pFree + pFree->count == m_pHead + m_BlockAmount;
+}
+
+MemoryStats RelocatableMemoryAllocator::GetStats() const
+{
+	return m_Stats.Snapshot(m_BlockAmount - 1, [this](uint32_t, auto visit)
+	{
+		for (const Block* pRun = m_pHead->pNext; pRun != nullptr; pRun = pRun->pNext)
+			visit(size_t(pRun->count));
+	});
+}
+
+RelocatableMemoryAllocator::Block* RelocatableMemoryAllocator::AcquireOnce(size_t blockAmount)
+{
+	Block* pPrevious = m_pHead;
+	Block* pRun = m_pHead->pNext;
+	while (pRun != nullptr && pRun->count < blockAmount)
+	{
+		pPrevious = pRun;
+		pRun = pRun->pNext;
+	}
+	if (pRun == nullptr)
+		return nullptr;
+
+	m_Stats.RemoveFreeRun(pRun->count);
+	if (pRun->count > blockAmount)
+	{
+		Block* pRest = pRun + blockAmount;
+		SetFree(pRest, pRun->count - blockAmount);
+		pRest->pNext = pRun->pNext;
+		pPrevious->pNext = pRest;
+		m_Stats.AddFreeRun(pRest->count);
+	}
+	else
+		pPrevious->pNext = pRun->pNext;
+
+	SetReserved(pRun, blockAmount, NullHandle);
+	m_Stats.AddUsed(blockAmount);
+	return pRun;
+}
+
+bool RelocatableMemoryAllocator::ReserveHandle() noexcept
+{
+	if (m_FreeHandle != NullHandle)
+		return true;
+	if (m_Handles.size() > std::numeric_limits<Handle>::max())
+		return false;
+
+	try
+	{
+		m_Handles.push_back(HandleSlot{});
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	m_FreeHandle = Handle(m_Handles.size() - 1);
+	m_Handles[m_FreeHandle].nextFree = NullHandle;
+	return true;
+}
+
+bool RelocatableMemoryAllocator::SlideDown()
+{
+	// runs are merged on release, so the lowest one is followed by a live block or the end
+	Block* pFree = m_pHead->pNext;
+	if (pFree == nullptr)
+		return false;
+	Block* pLive = pFree + pFree->count;
+	if (pLive == m_pHead + m_BlockAmount)
+		return false;
+
+	const size_t freeCount = pFree->count;
+	const size_t liveCount = pLive->count;
+	Block* pNextFree = pFree->pNext;
+	memmove(pFree, pLive, liveCount * sizeof(Block));
+	m_Handles[pFree->handle].pBlock = pFree;
+
+	// the hole moves up behind the block and swallows the run behind it
+	Block* pHole = pFree + liveCount;
+	size_t count = freeCount;
+	m_Stats.RemoveFreeRun(freeCount);
+	if (pHole + count == pNextFree)
+	{
+		count += pNextFree->count;
+		m_Stats.RemoveFreeRun(pNextFree->count);
+		pNextFree = pNextFree->pNext;
+	}
+	SetFree(pHole, count);
+	pHole->pNext = pNextFree;
+	m_pHead->pNext = pHole;
+	m_Stats.AddFreeRun(count);
+	return true;
+}
+
+void RelocatableMemoryAllocator::SetFree(Block* pBlock, size_t count)
+{
+	pBlock->handle = NullHandle;
+	pBlock->count = uint32_t(count);
+}
+
+void RelocatableMemoryAllocator::SetReserved(Block* pBlock, size_t count, Handle handle)
+{
+	pBlock->handle = handle;
+	pBlock->count = uint32_t(count);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "MemoryBlock.h"
+#include "BackingStore.h"
+#include "MemoryStats.h"
+#include "OutOfMemoryHandler.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Hands out handles instead of pointers so live blocks can be moved. Compact slides the block
+// behind the lowest free run down in front of it, one block at a time, and updates the handle
+// table; called once per frame with a small budget it removes external fragmentation without
+// a pause. Free runs are kept in one address ordered list, Acquire takes the first that fits.
+// A pointer from Resolve stays valid until the next Compact or Acquire.
+class RelocatableMemoryAllocator
+{
+public:
+	using Handle = uint32_t;
+	using Block = RelocatableBlock;
+	enum : Handle { NullHandle = 0 };
+
+	RelocatableMemoryAllocator(size_t nbBytes, eBackingStore store = eBackingStore::Heap);
+	~RelocatableMemoryAllocator();
+	// compacts the whole arena when no run fits but enough blocks are free in total
+	Handle Acquire(size_t nbBytes = 0);
+	// like Acquire, but returns NullHandle once compacting and the out of memory handler give up
+	Handle TryAcquire(size_t nbBytes = 0) noexcept;
+	// the handle is reused by a later Acquire
+	void Release(Handle handle);
+	void* Resolve(Handle handle) const { return m_Handles[handle].pBlock->data; };
+	size_t GetSize(Handle handle) const { return m_Handles[handle].pBlock->count * sizeof(Block) - sizeof(RelocatableHeader); };
+	// moves blocks until the free blocks are one run at the end or the budget is used up,
+	// at least one block is moved per call when there is a hole; returns how many were moved
+	size_t Compact(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+	// true while there is no free run in front of a live block
+	bool IsCompact() const;
+	Block* GetHead() const { return m_pHead; };
+	size_t GetBlockAmount() const { return m_BlockAmount; };
+	eBackingStore GetBackingStore() const { return m_Store; };
+	MemoryStats GetStats() const;
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
+	inline static size_t CalculateBlockAmount(const size_t nbBytes)
+	{
+		return size_t((nbBytes + sizeof(RelocatableHeader) + sizeof(Block) - 1) / sizeof(Block));
+	};
+
+	RelocatableMemoryAllocator(const RelocatableMemoryAllocator& other) = delete;
+	RelocatableMemoryAllocator(RelocatableMemoryAllocator&& other) = delete;
+	RelocatableMemoryAllocator& operator=(const RelocatableMemoryAllocator& other) = delete;
+	RelocatableMemoryAllocator& operator=(RelocatableMemoryAllocator&& other) = delete;
+
+private:
+	// live handles point to their block, released ones chain the free handles
+	union HandleSlot
+	{
+		Block* pBlock;
+		Handle nextFree;
+	};
+
+	Block* m_pHead;
+	size_t m_BlockAmount;
+	eBackingStore m_Store;
+	// slot 0 is never handed out, it stands for NullHandle
+	std::vector<HandleSlot> m_Handles;
+	Handle m_FreeHandle;
+	MemoryStatsCounter m_Stats;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	// a single first fit search, nullptr when nothing fits
+	Block* AcquireOnce(size_t blockAmount);
+	// makes sure m_FreeHandle names a slot, false when the table cannot grow
+	bool ReserveHandle() noexcept;
+	// moves the block behind the lowest free run to its start, false when already compact
+	bool SlideDown();
+	void SetFree(Block* pBlock, size_t count);
+	void SetReserved(Block* pBlock, size_t count, Handle handle);
+};
@@ -0,0 +1,54 @@
+#include "SmallObjectMemoryAllocator.h"
+#include <new>
+
+SmallObjectMemoryAllocator::SmallObjectMemoryAllocator(size_t poolBytes, size_t listBytes, size_t cellBlocks, eFreeListMode mode)
+	: m_Pool{ poolBytes, cellBlocks }
+	, m_List{ listBytes, mode }
+{
+}
+
+void* SmallObjectMemoryAllocator::Acquire(size_t nbBytes)
+{
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+void* SmallObjectMemoryAllocator::TryAcquire(size_t nbBytes) noexcept
+{
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce(nbBytes);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
+}
+
+void* SmallObjectMemoryAllocator::AcquireOnce(size_t nbBytes)
+{
+	if (nbBytes <= m_Pool.GetCellBytes())
+	{
+		void* pData = m_Pool.TryAcquire(nbBytes);
+		if (pData)
+			return pData;
+	}
+
+	std::lock_guard<std::mutex> lock{ m_ListMutex };
+	return m_List.TryAcquire(nbBytes);
+}
+
+void SmallObjectMemoryAllocator::Release(void* pStart)
+{
+	if (pStart == nullptr)
+		return;
+
+	if (m_Pool.Owns(pStart))
+	{
+		m_Pool.Release(pStart);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock{ m_ListMutex };
+	m_List.Release(pStart);
+}
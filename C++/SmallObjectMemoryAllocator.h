@@ -0,0 +1,39 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "PoolMemoryAllocator.h"
+#include "LinkedListMemoryAllocator.h"
+#include "OutOfMemoryHandler.h"
+#include <mutex>
+
+// Serves requests that fit a pool cell lock-free from a PoolMemoryAllocator,
+// everything else (and pool overflow) from a LinkedListMemoryAllocator behind a lock.
+class SmallObjectMemoryAllocator : public MemoryAllocator
+{
+public:
+	SmallObjectMemoryAllocator(size_t poolBytes, size_t listBytes, size_t cellBlocks = 2, eFreeListMode mode = eFreeListMode::Segregated);
+	virtual ~SmallObjectMemoryAllocator() = default;
+	virtual void* Acquire(size_t nbBytes = 0) override;
+	// like Acquire, but returns nullptr once the pool and the list are full and the
+	// out of memory handler gives up
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	virtual void Release(void* pStart) override;
+	// not synchronized, set it before other threads use the allocator. it runs without any
+	// lock held, so it may release into this allocator
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
+	const PoolMemoryAllocator& GetPool() const { return m_Pool; };
+	const LinkedListMemoryAllocator& GetList() const { return m_List; };
+
+	SmallObjectMemoryAllocator(const SmallObjectMemoryAllocator& other) = delete;
+	SmallObjectMemoryAllocator(SmallObjectMemoryAllocator&& other) = delete;
+	SmallObjectMemoryAllocator& operator=(const SmallObjectMemoryAllocator& other) = delete;
+	SmallObjectMemoryAllocator& operator=(SmallObjectMemoryAllocator&& other) = delete;
+
+private:
+	PoolMemoryAllocator m_Pool;
+	LinkedListMemoryAllocator m_List;
+	std::mutex m_ListMutex;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	// a single attempt without the handler, nullptr when neither the pool nor the list fits
+	void* AcquireOnce(size_t nbBytes);
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+// The block allocators only guarantee pointer alignment for the data they return,
+// stricter alignments over-acquire and keep the original pointer in front of the aligned one.
+inline void* AcquireAligned(MemoryAllocator& allocator, size_t nbBytes, size_t alignment)
+{
+	try
+	{
+		if (alignment <= alignof(void*))
+			return allocator.Acquire(nbBytes);
+
+		if (nbBytes > std::numeric_limits<size_t>::max() - alignment - sizeof(void*))
+			throw std::bad_alloc{};
+
+		void* pStart = allocator.Acquire(nbBytes + alignment + sizeof(void*));
+		const uintptr_t address = reinterpret_cast<uintptr_t>(pStart) + sizeof(void*);
+		void** pAligned = reinterpret_cast<void**>((address + alignment - 1) & ~uintptr_t(alignment - 1));
+		pAligned[-1] = pStart;
+		return pAligned;
+	}
+	catch (const std::bad_alloc&)
+	{
+		throw;
+	}
+	catch (const std::exception&)
+	{
+		// containers expect bad_alloc when the arena is exhausted
+		throw std::bad_alloc{};
+	}
+}
+
+inline void ReleaseAligned(MemoryAllocator& allocator, void* pStart, size_t alignment)
+{
+	if (pStart == nullptr)
+		return;
+
+	if (alignment <= alignof(void*))
+		allocator.Release(pStart);
+	else
+		allocator.Release(reinterpret_cast<void**>(pStart)[-1]);
+}
+
+// std::allocator compatible adapter, e.g. std::vector<Vector2, StlAllocator<Vector2>> v{ StlAllocator<Vector2>{ arena } };
+template<typename T>
+class StlAllocator
+{
+public:
+	using value_type = T;
+
+	StlAllocator(MemoryAllocator& allocator) noexcept : m_pAllocator{ &allocator } {};
+	template<typename U>
+	StlAllocator(const StlAllocator<U>& other) noexcept : m_pAllocator{ other.GetAllocator() } {};
+
+	T* allocate(size_t amount)
+	{
+		if (amount > std::numeric_limits<size_t>::max() / sizeof(T))
+			throw std::bad_array_new_length{};
+		return static_cast<T*>(AcquireAligned(*m_pAllocator, amount * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* pStart, size_t) noexcept
+	{
+		ReleaseAligned(*m_pAllocator, pStart, alignof(T));
+	}
+
+	MemoryAllocator* GetAllocator() const noexcept { return m_pAllocator; };
+
+	template<typename U>
+	bool operator==(const StlAllocator<U>& other) const noexcept { return m_pAllocator == other.GetAllocator(); };
+	template<typename U>
+	bool operator!=(const StlAllocator<U>& other) const noexcept { return m_pAllocator != other.GetAllocator(); };
+
+private:
+	MemoryAllocator* m_pAllocator;
+};
+
+// polymorphic adapter, e.g. std::pmr::vector<Vector2> v{ &resource };
+class MemoryAllocatorResource : public std::pmr::memory_resource
+{
+public:
+	explicit MemoryAllocatorResource(MemoryAllocator& allocator) noexcept : m_Allocator{ allocator } {};
+	MemoryAllocator& GetAllocator() const noexcept { return m_Allocator; };
+
+protected:
+	virtual void* do_allocate(size_t nbBytes, size_t alignment) override
+	{
+		return AcquireAligned(m_Allocator, nbBytes, alignment);
+	}
+
+	virtual void do_deallocate(void* pStart, size_t, size_t alignment) override
+	{
+		ReleaseAligned(m_Allocator, pStart, alignment);
+	}
+
+	virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		const MemoryAllocatorResource* pOther = dynamic_cast<const MemoryAllocatorResource*>(&other);
+		return pOther && &pOther->m_Allocator == &m_Allocator;
+	}
+
+private:
+	MemoryAllocator& m_Allocator;
+};
@@ -0,0 +1,230 @@
+#include "TLSFMemoryAllocator.h"
+#include "BitScan.h"
+#include <iostream>
+#include <new>
+
+TLSFMemoryAllocator::TLSFMemoryAllocator(size_t nbBytes)
+	: m_BlockAmount{ size_t((nbBytes + 2 * sizeof(TLSFBlock) - 1) / sizeof(TLSFBlock)) }
+	, m_FirstLevelBitmap{ 0 }
+	, m_SecondLevelBitmaps{}
+	, m_pFreeLists{}
+{
+	m_pHead = reinterpret_cast<TLSFBlock*>(malloc(m_BlockAmount * sizeof(TLSFBlock)));
+	if (!m_pHead)
+		throw std::bad_alloc{};
+
+	m_pHead->isFree = false;
+	m_pHead->isPreviousFree = false;
+	m_pHead->count = 0;
+
+	TLSFBlock* pFirst = m_pHead + 1;
+	pFirst->isPreviousFree = false;
+	SetFree(pFirst, m_BlockAmount - 1);
+	InsertFree(pFirst);
+}
+
+TLSFMemoryAllocator::~TLSFMemoryAllocator()
+{
+	free(reinterpret_cast<void*>(m_pHead));
+}
+
+void* TLSFMemoryAllocator::Acquire(size_t nbBytes)
+{
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+void* TLSFMemoryAllocator::TryAcquire(size_t nbBytes) noexcept
+{
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce(nbBytes);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
+}
+
+void* TLSFMemoryAllocator::AcquireOnce(size_t nbBytes)
+{
+	size_t blockAmount = CalculateBlockAmount(nbBytes);
+	TLSFBlock* pBlock = FindSuitable(blockAmount);
+	if (!pBlock)
+		return nullptr;
+
+	RemoveFree(pBlock);
+	if (pBlock->count > blockAmount)
+	{
+		TLSFBlock* pRest = pBlock + blockAmount;
+		SetFree(pRest, pBlock->count - blockAmount);
+		InsertFree(pRest);
+	}
+	SetReserved(pBlock, blockAmount);
+	return pBlock->data;
+}
+
+void TLSFMemoryAllocator::Release(void* pStart)
+{
+	// Check if pStart is part of buffer
+	if (pStart == nullptr || pStart < m_pHead + 1 || m_pHead + m_BlockAmount <= pStart)
+		return;
+
+	TLSFBlock* pBlock = reinterpret_cast<TLSFBlock*>(reinterpret_cast<TLSFHeader*>(pStart) - 1);
+	TLSFBlock* pRunStart = pBlock;
+	size_t count = pBlock->count;
+
+	// block behind is empty
+	TLSFBlock* pNext = pBlock + pBlock->count;
+	if (pNext < m_pHead + m_BlockAmount && pNext->isFree)
+	{
+		RemoveFree(pNext);
+		count += pNext->count;
+	}
+
+	// block in front is empty, its footer holds its size
+	if (pBlock->isPreviousFree)
+	{
+		pRunStart = pBlock - (pBlock - 1)->count;
+		RemoveFree(pRunStart);
+		count += pRunStart->count;
+	}
+
+	SetFree(pRunStart, count);
+	InsertFree(pRunStart);
+}
+
+std::string TLSFMemoryAllocator::UsageToString(const char header, const char begin, const char unused, const char used) const
+{
+	if (!m_pHead)
+		return "TLSFMA | Head is nullptr";
+
+	std::string string{ header };
+	TLSFBlock* pCurrent = m_pHead + 1;
+	TLSFBlock* pEnd = m_pHead + m_BlockAmount;
+
+	while (pCurrent < pEnd)
+	{
+		if (pCurrent->isFree)
+		{
+			string += begin;
+			string += std::string(pCurrent->count - 1, unused);
+		}
+		else
+			string += std::string(pCurrent->count, used);
+		pCurrent = pCurrent + pCurrent->count;
+	}
+	return string;
+}
+
+void TLSFMemoryAllocator::Visualize() const
+{
+	std::cout << UsageToString() << std::endl;
+}
+
+bool TLSFMemoryAllocator::CheckMemory(std::string expected, const char header, const char begin, const char unused, const char used) const
+{
+	std::string result{ UsageToString(header, begin, unused, used) };
+	return expected == result;
+}
+
+void TLSFMemoryAllocator::Mapping(size_t count, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+	if (count < SecondLevelAmount)
+	{
+		firstLevel = 0;
+		secondLevel = uint32_t(count);
+		return;
+	}
+	const uint32_t highestBit = FindLastSet(count);
+	firstLevel = highestBit - SecondLevelLog2 + 1;
+	secondLevel = uint32_t(count >> (highestBit - SecondLevelLog2)) - SecondLevelAmount;
+}
+
+TLSFBlock* TLSFMemoryAllocator::FindSuitable(size_t count) const
+{
+	// round up to the next second level list, so every run in it is big enough
+	if (count >= SecondLevelAmount)
+	{
+		const size_t round = (size_t(1) << (FindLastSet(count) - SecondLevelLog2)) - 1;
+		if (count > std::numeric_limits<size_t>::max() - round)
+			return nullptr;
+		count += round;
+	}
+
+	uint32_t firstLevel, secondLevel;
+	Mapping(count, firstLevel, secondLevel);
+	if (firstLevel >= FirstLevelAmount)
+		return nullptr;
+
+	uint32_t secondLevelMap = m_SecondLevelBitmaps[firstLevel] & (~uint32_t(0) << secondLevel);
+	if (!secondLevelMap)
+	{
+		const uint64_t firstLevelMap = firstLevel + 1 < 64 ? m_FirstLevelBitmap & (~uint64_t(0) << (firstLevel + 1)) : 0;
+		if (!firstLevelMap)
+			return nullptr;
+
+		firstLevel = FindFirstSet(firstLevelMap);
+		secondLevelMap = m_SecondLevelBitmaps[firstLevel];
+	}
+	return m_pFreeLists[firstLevel][FindFirstSet(secondLevelMap)];
+}
+
+void TLSFMemoryAllocator::InsertFree(TLSFBlock* pBlock)
+{
+	uint32_t firstLevel, secondLevel;
+	Mapping(pBlock->count, firstLevel, secondLevel);
+
+	TLSFBlock*& pListHead = m_pFreeLists[firstLevel][secondLevel];
+	pBlock->links.pPrevious = nullptr;
+	pBlock->links.pNext = pListHead;
+	if (pListHead)
+		pListHead->links.pPrevious = pBlock;
+	pListHead = pBlock;
+
+	m_FirstLevelBitmap |= uint64_t(1) << firstLevel;
+	m_SecondLevelBitmaps[firstLevel] |= uint32_t(1) << secondLevel;
+}
+
+void TLSFMemoryAllocator::RemoveFree(TLSFBlock* pBlock)
+{
+	uint32_t firstLevel, secondLevel;
+	Mapping(pBlock->count, firstLevel, secondLevel);
+
+	TLSFBlock*& pListHead = m_pFreeLists[firstLevel][secondLevel];
+	if (pBlock->links.pPrevious)
+		pBlock->links.pPrevious->links.pNext = pBlock->links.pNext;
+	else
+		pListHead = pBlock->links.pNext;
+
+	if (pBlock->links.pNext)
+		pBlock->links.pNext->links.pPrevious = pBlock->links.pPrevious;
+
+	if (!pListHead)
+	{
+		m_SecondLevelBitmaps[firstLevel] &= ~(uint32_t(1) << secondLevel);
+		if (!m_SecondLevelBitmaps[firstLevel])
+			m_FirstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+	}
+}
+
+void TLSFMemoryAllocator::SetFree(TLSFBlock* pBlock, size_t count)
+{
+	pBlock->isFree = true;
+	pBlock->count = count;
+	(pBlock + count - 1)->count = count;
+
+	TLSFBlock* pNext = pBlock + count;
+	if (pNext < m_pHead + m_BlockAmount)
+		pNext->isPreviousFree = true;
+}
+
+void TLSFMemoryAllocator::SetReserved(TLSFBlock* pBlock, size_t count)
+{
+	pBlock->isFree = false;
+	pBlock->count = count;
+
+	TLSFBlock* pNext = pBlock + count;
+	if (pNext < m_pHead + m_BlockAmount)
+		pNext->isPreviousFree = false;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "MemoryBlock.h"
+#include "OutOfMemoryHandler.h"
+#include <string>
+
+// two level segregated fit: free runs are sorted into power of two first level classes,
+// each split linearly into second level lists, so Acquire and Release are O(1)
+class TLSFMemoryAllocator : public MemoryAllocator
+{
+public:
+	TLSFMemoryAllocator(size_t nbBytes);
+	virtual ~TLSFMemoryAllocator();
+	virtual void* Acquire(size_t nbBytes = 0) override;
+	// like Acquire, but returns nullptr once the out of memory handler gives up
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	virtual void Release(void* pStart) override;
+	TLSFBlock* GetHead() const { return m_pHead; };
+	size_t GetBlockAmount() const { return m_BlockAmount; };
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
+	std::string UsageToString(const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
+	void Visualize() const;
+	bool CheckMemory(std::string expected, const char header = CHeader, const char begin = CBegin, const char unused = CUnused, const char used = CUsed) const;
+	inline static size_t CalculateBlockAmount(const size_t nbBytes)
+	{
+		return size_t((nbBytes + sizeof(TLSFHeader) + sizeof(TLSFBlock) - 1) / sizeof(TLSFBlock));
+	};
+private:
+	enum
+	{
+		SecondLevelLog2 = 4,
+		SecondLevelAmount = 1 << SecondLevelLog2,
+		FirstLevelAmount = std::numeric_limits<size_t>::digits - SecondLevelLog2 + 1,
+	};
+
+	TLSFBlock* m_pHead;
+	size_t m_BlockAmount;
+	uint64_t m_FirstLevelBitmap;
+	uint32_t m_SecondLevelBitmaps[FirstLevelAmount];
+	TLSFBlock* m_pFreeLists[FirstLevelAmount][SecondLevelAmount];
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	// a single search without the handler, nullptr when nothing fits
+	void* AcquireOnce(size_t nbBytes);
+	static void Mapping(size_t count, uint32_t& firstLevel, uint32_t& secondLevel);
+	TLSFBlock* FindSuitable(size_t count) const;
+	void InsertFree(TLSFBlock* pBlock);
+	void RemoveFree(TLSFBlock* pBlock);
+	void SetFree(TLSFBlock* pBlock, size_t count);
+	void SetReserved(TLSFBlock* pBlock, size_t count);
+};
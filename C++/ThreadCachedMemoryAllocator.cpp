@@ -0,0 +1,251 @@
+#include "ThreadCachedMemoryAllocator.h"
+#include "BitScan.h"
+#include <algorithm>
+#include <new>
+
+std::atomic<size_t> ThreadCachedMemoryAllocator::s_NextId{ 0 };
+
+ThreadCachedMemoryAllocator::ThreadCachedMemoryAllocator(size_t nbBytes)
+	: m_Shared{ nbBytes }
+	, m_Id{ s_NextId++ }
+{
+	std::lock_guard<std::mutex> lock{ GetAllocatorsMutex() };
+	GetAllocators().emplace(m_Id, this);
+}
+
+ThreadCachedMemoryAllocator::~ThreadCachedMemoryAllocator()
+{
+	// waits for exiting threads that are flushing into this allocator,
+	// cached blocks live inside the shared arena, they go away with it
+	std::lock_guard<std::mutex> lock{ GetAllocatorsMutex() };
+	GetAllocators().erase(m_Id);
+}
+
+void* ThreadCachedMemoryAllocator::Acquire(size_t nbBytes)
+{
+	void* pData = TryAcquire(nbBytes);
+	if (!pData)
+		throw std::bad_alloc{};
+	return pData;
+}
+
+void* ThreadCachedMemoryAllocator::TryAcquire(size_t nbBytes) noexcept
+{
+	for (size_t attempt = 0; ; attempt++)
+	{
+		void* pData = AcquireOnce(nbBytes);
+		if (pData || !ShouldRetry(m_OnOutOfMemory, nbBytes, attempt))
+			return pData;
+	}
+}
+
+void* ThreadCachedMemoryAllocator::AcquireOnce(size_t nbBytes)
+{
+	// the payload has to be able to hold the remote free link
+	const size_t totalBytes = std::max(nbBytes, sizeof(CacheHeader*)) + sizeof(CacheHeader);
+	const size_t blockAmount = DoubleLinkedListMemoryAllocator::CalculateBlockAmount(totalBytes);
+	size_t sizeClass = FindLastSet(blockAmount);
+	if ((size_t(1) << sizeClass) < blockAmount)
+		sizeClass++;
+
+	if (sizeClass >= ClassAmount)
+	{
+		CacheHeader* pHeader;
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			pHeader = reinterpret_cast<CacheHeader*>(m_Shared.TryAcquire(totalBytes));
+		}
+		if (!pHeader)
+			return nullptr;
+		pHeader->pOwner = nullptr;
+		pHeader->sizeClass = ClassAmount;
+		return pHeader + 1;
+	}
+
+	ThreadCache* pCache;
+	try
+	{
+		pCache = GetCache();
+	}
+	catch (const std::exception&)
+	{
+		// the bookkeeping of a new thread lives on the heap, out of it is out of memory too
+		return nullptr;
+	}
+	if (pCache->counts[sizeClass] == 0)
+		DrainRemoteFrees(pCache);
+	if (pCache->counts[sizeClass] == 0 && !Refill(pCache, sizeClass))
+		return nullptr;
+
+	CacheHeader* pHeader = pCache->pMagazines[sizeClass][--pCache->counts[sizeClass]];
+	pHeader->pOwner = pCache;
+	pHeader->sizeClass = sizeClass;
+	return pHeader + 1;
+}
+
+void ThreadCachedMemoryAllocator::Release(void* pStart)
+{
+	if (pStart == nullptr)
+		return;
+
+	CacheHeader* pHeader = reinterpret_cast<CacheHeader*>(pStart) - 1;
+	if (pHeader->sizeClass >= ClassAmount)
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_Shared.Release(pHeader);
+		return;
+	}
+
+	ThreadCache* pCache = GetCache();
+	if (pHeader->pOwner != pCache)
+	{
+		// acquired by another thread, hand it back to its owner
+		ThreadCache* pOwner = pHeader->pOwner;
+		CacheHeader* pFirst = pOwner->pRemoteFrees.load(std::memory_order_relaxed);
+		do
+		{
+			NextRemote(pHeader) = pFirst;
+		} while (!pOwner->pRemoteFrees.compare_exchange_weak(pFirst, pHeader, std::memory_order_release, std::memory_order_relaxed));
+		return;
+	}
+
+	PushToMagazine(pCache, pHeader);
+}
+
+void ThreadCachedMemoryAllocator::ReleaseThreadCache()
+{
+	auto& caches = GetThreadCaches();
+	auto it = std::find_if(caches.begin(), caches.end(), [this](const std::pair<size_t, ThreadCache*>& entry) { return entry.first == m_Id; });
+	if (it == caches.end())
+		return;
+
+	ThreadCache* pCache = it->second;
+	caches.erase(it);
+	ReleaseCache(pCache);
+}
+
+void ThreadCachedMemoryAllocator::ReleaseCache(ThreadCache* pCache)
+{
+	DrainRemoteFrees(pCache);
+	for (size_t i = 0; i < ClassAmount; i++)
+		Flush(pCache, i, pCache->counts[i]);
+
+	// the next new thread adopts the cache, together with anything freed into it later
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	pCache->isOrphaned = true;
+}
+
+std::vector<std::pair<size_t, ThreadCachedMemoryAllocator::ThreadCache*>>& ThreadCachedMemoryAllocator::GetThreadCaches()
+{
+	static thread_local ThreadCacheList caches{};
+	return caches.entries;
+}
+
+ThreadCachedMemoryAllocator::ThreadCacheList::~ThreadCacheList()
+{
+	std::lock_guard<std::mutex> lock{ GetAllocatorsMutex() };
+	const auto& allocators = GetAllocators();
+	for (const auto& entry : entries)
+	{
+		auto it = allocators.find(entry.first);
+		if (it != allocators.end())
+			it->second->ReleaseCache(entry.second);
+	}
+}
+
+std::unordered_map<size_t, ThreadCachedMemoryAllocator*>& ThreadCachedMemoryAllocator::GetAllocators()
+{
+	static std::unordered_map<size_t, ThreadCachedMemoryAllocator*> allocators{};
+	return allocators;
+}
+
+std::mutex& ThreadCachedMemoryAllocator::GetAllocatorsMutex()
+{
+	static std::mutex mutex{};
+	return mutex;
+}
+
+ThreadCachedMemoryAllocator::ThreadCache* ThreadCachedMemoryAllocator::GetCache()
+{
+	auto& caches = GetThreadCaches();
+	for (const auto& entry : caches)
+	{
+		if (entry.first == m_Id)
+			return entry.second;
+	}
+
+	ThreadCache* pCache = nullptr;
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		for (const auto& pOther : m_Caches)
+		{
+			if (pOther->isOrphaned)
+			{
+				pCache = pOther.get();
+				pCache->isOrphaned = false;
+				break;
+			}
+		}
+		if (!pCache)
+		{
+			m_Caches.push_back(std::make_unique<ThreadCache>());
+			pCache = m_Caches.back().get();
+		}
+	}
+	caches.push_back({ m_Id, pCache });
+	return pCache;
+}
+
+bool ThreadCachedMemoryAllocator::Refill(ThreadCache* pCache, size_t sizeClass)
+{
+	const size_t classBytes = GetClassBytes(sizeClass);
+	size_t& count = pCache->counts[sizeClass];
+
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	while (count < BatchSize)
+	{
+		void* pData = m_Shared.TryAcquire(classBytes);
+		if (!pData)
+			break;
+		pCache->pMagazines[sizeClass][count] = reinterpret_cast<CacheHeader*>(pData);
+		count++;
+	}
+	return count != 0;
+}
+
+void ThreadCachedMemoryAllocator::Flush(ThreadCache* pCache, size_t sizeClass, size_t amount)
+{
+	if (amount == 0)
+		return;
+
+	size_t& count = pCache->counts[sizeClass];
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	for (size_t i = 0; i < amount; i++)
+		m_Shared.Release(pCache->pMagazines[sizeClass][--count]);
+}
+
+void ThreadCachedMemoryAllocator::DrainRemoteFrees(ThreadCache* pCache)
+{
+	CacheHeader* pCurrent = pCache->pRemoteFrees.exchange(nullptr, std::memory_order_acquire);
+	while (pCurrent)
+	{
+		CacheHeader* pNext = NextRemote(pCurrent);
+		PushToMagazine(pCache, pCurrent);
+		pCurrent = pNext;
+	}
+}
+
+void ThreadCachedMemoryAllocator::PushToMagazine(ThreadCache* pCache, CacheHeader* pHeader)
+{
+	const size_t sizeClass = pHeader->sizeClass;
+	if (pCache->counts[sizeClass] == MagazineSize)
+		Flush(pCache, sizeClass, BatchSize);
+
+	pCache->pMagazines[sizeClass][pCache->counts[sizeClass]++] = pHeader;
+}
+
+size_t ThreadCachedMemoryAllocator::GetClassBytes(size_t sizeClass)
+{
+	// exactly fills 2^sizeClass blocks of the shared list
+	return (size_t(1) << sizeClass) * sizeof(DoubleLinkBlock) - sizeof(DoubleLinkHeader);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "DoubleLinkedListMemoryAllocator.h"
+#include "OutOfMemoryHandler.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Shares one DoubleLinkedListMemoryAllocator between threads. Every thread keeps magazines
+// of recently freed blocks per power of two size class, so most Acquire/Release calls
+// never take the lock. Blocks freed by another thread than the one that acquired them are
+// handed back through the owner's remote free queue. A thread's magazines go back to the
+// shared list when the thread exits.
+class ThreadCachedMemoryAllocator : public MemoryAllocator
+{
+public:
+	ThreadCachedMemoryAllocator(size_t nbBytes);
+	virtual ~ThreadCachedMemoryAllocator();
+	virtual void* Acquire(size_t nbBytes = 0) override;
+	// like Acquire, but returns nullptr once the out of memory handler gives up
+	void* TryAcquire(size_t nbBytes = 0) noexcept;
+	virtual void Release(void* pStart) override;
+	// not synchronized, set it before other threads use the allocator. it runs without any
+	// lock held, so it may release into this allocator
+	void SetOutOfMemoryHandler(OutOfMemoryHandler handler) { m_OnOutOfMemory = std::move(handler); };
+
+	// returns the calling thread's cached blocks to the shared list before the thread exits
+	void ReleaseThreadCache();
+
+	ThreadCachedMemoryAllocator(const ThreadCachedMemoryAllocator& other) = delete;
+	ThreadCachedMemoryAllocator(ThreadCachedMemoryAllocator&& other) = delete;
+	ThreadCachedMemoryAllocator& operator=(const ThreadCachedMemoryAllocator& other) = delete;
+	ThreadCachedMemoryAllocator& operator=(ThreadCachedMemoryAllocator&& other) = delete;
+
+private:
+	enum { ClassAmount = 8, MagazineSize = 64, BatchSize = 32 };
+
+	struct ThreadCache;
+	struct CacheHeader
+	{
+		ThreadCache* pOwner;
+		size_t sizeClass;
+	};
+	struct ThreadCache
+	{
+		CacheHeader* pMagazines[ClassAmount][MagazineSize];
+		size_t counts[ClassAmount] = {};
+		std::atomic<CacheHeader*> pRemoteFrees{ nullptr };
+		bool isOrphaned = false;
+	};
+
+	// the caches of one thread, flushed into the allocators that are still alive when it exits
+	struct ThreadCacheList
+	{
+		std::vector<std::pair<size_t, ThreadCache*>> entries;
+		~ThreadCacheList();
+	};
+
+	DoubleLinkedListMemoryAllocator m_Shared;
+	std::mutex m_Mutex;
+	std::vector<std::unique_ptr<ThreadCache>> m_Caches;
+	const size_t m_Id;
+	OutOfMemoryHandler m_OnOutOfMemory;
+
+	static std::atomic<size_t> s_NextId;
+
+	static std::vector<std::pair<size_t, ThreadCache*>>& GetThreadCaches();
+	// allocators by id, an exiting thread only touches the ones found here
+	static std::unordered_map<size_t, ThreadCachedMemoryAllocator*>& GetAllocators();
+	static std::mutex& GetAllocatorsMutex();
+	void ReleaseCache(ThreadCache* pCache);
+	// a single attempt without the handler, nullptr when the shared list has nothing that fits
+	void* AcquireOnce(size_t nbBytes);
+	ThreadCache* GetCache();
+	// false when not even one block could be taken from the shared list
+	bool Refill(ThreadCache* pCache, size_t sizeClass);
+	void Flush(ThreadCache* pCache, size_t sizeClass, size_t amount);
+	void DrainRemoteFrees(ThreadCache* pCache);
+	void PushToMagazine(ThreadCache* pCache, CacheHeader* pHeader);
+	static size_t GetClassBytes(size_t sizeClass);
+	static CacheHeader*& NextRemote(CacheHeader* pHeader) { return *reinterpret_cast<CacheHeader**>(pHeader + 1); };
+};
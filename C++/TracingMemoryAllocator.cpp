@@ -0,0 +1,141 @@
+#include "TracingMemoryAllocator.h"
+#include <algorithm>
+#include <limits>
+
+std::atomic<uint16_t> TracingMemoryAllocator::s_NextThreadId{ 0 };
+
+namespace
+{
+	size_t RoundUpToPowerOfTwo(size_t value)
+	{
+		size_t result = 1;
+		while (result < value)
+			result <<= 1;
+		return result;
+	}
+}
+
+TracingMemoryAllocator::TracingMemoryAllocator(MemoryAllocator& allocator, const std::string& path, size_t ringSize)
+	: m_Allocator{ allocator }
+	, m_Writer{}
+	, m_pRing{ std::make_unique<Slot[]>(RoundUpToPowerOfTwo(std::max(ringSize, size_t(2)))) }
+	, m_RingMask{ RoundUpToPowerOfTwo(std::max(ringSize, size_t(2))) - 1 }
+	, m_WriteIdx{ 0 }
+	, m_ReadIdx{ 0 }
+	, m_LastTime{ 0 }
+	, m_Start{ Clock::now() }
+	, m_StallAmount{ 0 }
+	, m_IsStopping{ false }
+{
+	m_Writer.Open(path);
+	for (size_t i = 0; i <= m_RingMask; i++)
+		m_pRing[i].sequence.store(i, std::memory_order_relaxed);
+
+	m_FlushThread = std::thread{ &TracingMemoryAllocator::FlushLoop, this };
+}
+
+TracingMemoryAllocator::~TracingMemoryAllocator()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_FlushMutex };
+		m_IsStopping = true;
+	}
+	m_FlushCondition.notify_one();
+	m_FlushThread.join();
+	Drain();
+	m_Writer.Close();
+}
+
+void* TracingMemoryAllocator::Acquire(size_t nbBytes)
+{
+	void* pData = m_Allocator.Acquire(nbBytes);
+	Push(eTraceOperation::Acquire, pData, nbBytes);
+	return pData;
+}
+
+void TracingMemoryAllocator::Release(void* pStart)
+{
+	if (pStart == nullptr)
+		return;
+
+	// recorded first, another thread may get the same address right after the release
+	Push(eTraceOperation::Release, pStart, 0);
+	m_Allocator.Release(pStart);
+}
+
+void TracingMemoryAllocator::Push(eTraceOperation operation, const void* pData, size_t nbBytes)
+{
+	const uint64_t time = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_Start).count());
+	const uint64_t idx = m_WriteIdx.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = m_pRing[idx & m_RingMask];
+
+	// ring is full, the flush thread has not written this slot of the last lap yet
+	if (slot.sequence.load(std::memory_order_acquire) != idx)
+	{
+		m_StallAmount.fetch_add(1, std::memory_order_relaxed);
+		m_FlushCondition.notify_one();
+		while (slot.sequence.load(std::memory_order_acquire) != idx)
+			std::this_thread::yield();
+	}
+
+	// the address doubles as id, CompactTraceIds makes reused addresses unique again
+	slot.time = time;
+	slot.record = { uint64_t(reinterpret_cast<uintptr_t>(pData)), uint64_t(nbBytes), 0, GetThreadId(), operation, 0 };
+	slot.sequence.store(idx + 1, std::memory_order_release);
+}
+
+void TracingMemoryAllocator::FlushLoop()
+{
+	std::unique_lock<std::mutex> lock{ m_FlushMutex };
+	while (!m_IsStopping)
+	{
+		lock.unlock();
+		const size_t amount = Drain();
+		lock.lock();
+		// keep going while there is work, otherwise look again a bit later
+		if (amount == 0)
+			m_FlushCondition.wait_for(lock, std::chrono::milliseconds(10));
+	}
+}
+
+size_t TracingMemoryAllocator::Drain()
+{
+	enum { BatchSize = 1024 };
+	TraceRecord batch[BatchSize];
+	size_t batchAmount = 0;
+	size_t amount = 0;
+
+	while (true)
+	{
+		Slot& slot = m_pRing[m_ReadIdx & m_RingMask];
+		if (slot.sequence.load(std::memory_order_acquire) != m_ReadIdx + 1)
+			break;
+
+		// threads can publish slightly out of time order, those get a delta of 0
+		TraceRecord& record = batch[batchAmount++];
+		record = slot.record;
+		const uint64_t delta = slot.time > m_LastTime ? slot.time - m_LastTime : 0;
+		record.timeDelta = uint32_t(std::min(delta, uint64_t(std::numeric_limits<uint32_t>::max())));
+		m_LastTime = std::max(m_LastTime, slot.time);
+
+		// hand the slot to the writer of the next lap
+		slot.sequence.store(m_ReadIdx + m_RingMask + 1, std::memory_order_release);
+		m_ReadIdx++;
+		amount++;
+
+		if (batchAmount == BatchSize)
+		{
+			m_Writer.Write(batch, batchAmount);
+			batchAmount = 0;
+		}
+	}
+	if (batchAmount)
+		m_Writer.Write(batch, batchAmount);
+	return amount;
+}
+
+uint16_t TracingMemoryAllocator::GetThreadId()
+{
+	thread_local const uint16_t threadId = s_NextThreadId++;
+	return threadId;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "AllocationTrace.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Records every Acquire/Release of the wrapped allocator into a lock free ring buffer,
+// a background thread writes it to a trace file (see AllocationTrace.h) that
+// Benchmarks/AllocatorBenchmark can replay. The wrapped allocator has to outlive the recorder.
+class TracingMemoryAllocator : public MemoryAllocator
+{
+public:
+	// ringSize is rounded up to a power of two
+	TracingMemoryAllocator(MemoryAllocator& allocator, const std::string& path, size_t ringSize = size_t(1) << 16);
+	virtual ~TracingMemoryAllocator();
+	virtual void* Acquire(size_t nbBytes = 0) override;
+	virtual void Release(void* pStart) override;
+	MemoryAllocator& GetAllocator() const { return m_Allocator; };
+	// how often a thread had to wait for the flush thread because the ring was full
+	size_t GetStallAmount() const { return m_StallAmount.load(std::memory_order_relaxed); };
+
+	TracingMemoryAllocator(const TracingMemoryAllocator& other) = delete;
+	TracingMemoryAllocator(TracingMemoryAllocator&& other) = delete;
+	TracingMemoryAllocator& operator=(const TracingMemoryAllocator& other) = delete;
+	TracingMemoryAllocator& operator=(TracingMemoryAllocator&& other) = delete;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// the sequence tells whose turn it is, writer of lap n waits for n * size + idx
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence;
+		uint64_t time;
+		TraceRecord record;
+	};
+
+	MemoryAllocator& m_Allocator;
+	TraceWriter m_Writer;
+	std::unique_ptr<Slot[]> m_pRing;
+	const size_t m_RingMask;
+	std::atomic<uint64_t> m_WriteIdx;
+	uint64_t m_ReadIdx;
+	uint64_t m_LastTime;
+	const Clock::time_point m_Start;
+	std::atomic<size_t> m_StallAmount;
+
+	std::thread m_FlushThread;
+	std::mutex m_FlushMutex;
+	std::condition_variable m_FlushCondition;
+	bool m_IsStopping;
+
+	static std::atomic<uint16_t> s_NextThreadId;
+
+	void Push(eTraceOperation operation, const void* pData, size_t nbBytes);
+	void FlushLoop();
+	// writes every published record, returns how many there were
+	size_t Drain();
+	static uint16_t GetThreadId();
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// compile time key of a TypedBlackboard, Slot is its position in the slot list
+template<typename T, size_t Slot>
+struct BlackboardSlot
+{
+	using Type = T;
+	enum : size_t { Index = Slot };
+};
+
+template<typename... TSlots, size_t... Is>
+constexpr bool AreSlotsInOrder(std::index_sequence<Is...>)
+{
+	return ((size_t(TSlots::Index) == Is) && ...);
+}
+
+template<typename T, typename = void>
+struct IsEqualityComparable : std::false_type {};
+
+template<typename T>
+struct IsEqualityComparable<T, decltype(void(std::declval<const T&>() == std::declval<const T&>()))> : std::true_type {};
+
+// All values live in one tuple, a slot is a plain load or store at a fixed offset. Set marks
+// a slot dirty unless its value compares equal, Publish hands only the dirty slots on to a
+// keyed blackboard (anything with AddData/ChangeData, like Elite::Blackboard).
+template<typename... TSlots>
+class TypedBlackboard
+{
+public:
+	enum : size_t { SlotAmount = sizeof...(TSlots) };
+	static_assert(SlotAmount <= 64, "dirty bits are kept in one 64 bit word");
+	static_assert(AreSlotsInOrder<TSlots...>(std::index_sequence_for<TSlots...>{}), "slot indices have to count up from 0 in list order");
+
+	template<typename TSlot>
+	const typename TSlot::Type& Get() const { return std::get<TSlot::Index>(m_Values); };
+
+	template<typename TSlot>
+	void Set(const typename TSlot::Type& value)
+	{
+		auto& current = std::get<TSlot::Index>(m_Values);
+		if constexpr (IsEqualityComparable<typename TSlot::Type>::value)
+		{
+			if (current == value)
+				return;
+		}
+		current = value;
+		m_DirtyBits |= uint64_t(1) << TSlot::Index;
+	};
+
+	template<typename TSlot>
+	bool IsDirty() const { return (m_DirtyBits & (uint64_t(1) << TSlot::Index)) != 0; };
+
+	// names the slot in the keyed blackboard and sets its start value, it is not dirty afterwards
+	template<typename TSlot>
+	void Bind(std::string key, const typename TSlot::Type& value)
+	{
+		m_Keys[TSlot::Index] = std::move(key);
+		std::get<TSlot::Index>(m_Values) = value;
+		m_DirtyBits &= ~(uint64_t(1) << TSlot::Index);
+	};
+
+	template<typename TBlackboard>
+	void AddTo(TBlackboard& blackboard) const
+	{
+		AddSlots(blackboard, std::index_sequence_for<TSlots...>{});
+	};
+
+	template<typename TBlackboard>
+	void Publish(TBlackboard& blackboard)
+	{
+		if (!m_DirtyBits)
+			return;
+		PublishSlots(blackboard, std::index_sequence_for<TSlots...>{});
+		m_DirtyBits = 0;
+	};
+
+	// false when the keyed blackboard holds another value than the one published for a slot that
+	// is not dirty, so something else wrote its key. types without operator== are not compared
+	template<typename TBlackboard>
+	bool MatchesPublished(TBlackboard& blackboard) const
+	{
+		return MatchSlots(blackboard, std::index_sequence_for<TSlots...>{});
+	};
+
+private:
+	std::tuple<typename TSlots::Type...> m_Values;
+	std::string m_Keys[SlotAmount];
+	uint64_t m_DirtyBits = 0;
+
+	template<typename TBlackboard, size_t... Is>
+	void AddSlots(TBlackboard& blackboard, std::index_sequence<Is...>) const
+	{
+		(blackboard.AddData(m_Keys[Is], std::get<Is>(m_Values)), ...);
+	};
+
+	template<typename TBlackboard, size_t... Is>
+	void PublishSlots(TBlackboard& blackboard, std::index_sequence<Is...>) const
+	{
+		((m_DirtyBits & (uint64_t(1) << Is) ? void(blackboard.ChangeData(m_Keys[Is], std::get<Is>(m_Values))) : void()), ...);
+	};
+
+	template<typename TBlackboard, size_t... Is>
+	bool MatchSlots(TBlackboard& blackboard, std::index_sequence<Is...>) const
+	{
+		return (MatchSlot<Is>(blackboard) && ...);
+	};
+
+	template<size_t I, typename TBlackboard>
+	bool MatchSlot(TBlackboard& blackboard) const
+	{
+		using T = std::tuple_element_t<I, std::tuple<typename TSlots::Type...>>;
+		if constexpr (IsEqualityComparable<T>::value)
+		{
+			if (m_DirtyBits & (uint64_t(1) << I))
+				return true;
+			T value{};
+			return blackboard.GetData(m_Keys[I], value) && value == std::get<I>(m_Values);
+		}
+		else
+			return true;
+	};
+};